@@ -0,0 +1,92 @@
+package com.kuro.android.opencv
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+
+import org.junit.Test
+import org.junit.runner.RunWith
+
+import org.junit.Assert.*
+
+/**
+ * Native handle registry seen through the public natives: generation-checked
+ * release and lookup, slot reuse, and per-type byte accounting.
+ */
+@RunWith(AndroidJUnit4::class)
+class HandleRegistryTest {
+
+    private val width = 64
+    private val height = 32
+    private val radius = 100f
+
+    private fun bytes(type: Int) = ChessBoardManager.getNativeHandleStats()[2 + 2 * type]
+    private fun count(type: Int) = ChessBoardManager.getNativeHandleStats()[3 + 2 * type]
+
+    @Test
+    fun releaseTwiceIsANoOp() {
+        val handle = ChessBoardManager.createCurvatureProfile(width, height, radius)
+        assertNotEquals(0L, handle)
+        assertTrue(ChessBoardManager.releaseNative(handle))
+        assertFalse(ChessBoardManager.releaseNative(handle))
+        assertFalse(ChessBoardManager.releaseNative(0L))
+    }
+
+    @Test
+    fun lookupAfterReleaseFails() {
+        val handle = ChessBoardManager.createCurvatureProfile(width, height, radius)
+        assertEquals(width, ChessBoardManager.curvatureProfileRow(handle)?.size)
+
+        ChessBoardManager.releaseNative(handle)
+        assertNull(ChessBoardManager.curvatureProfileRow(handle))
+        assertEquals(0L, ChessBoardManager.curvatureProfileDense(handle))
+    }
+
+    @Test
+    fun lookupWithTheWrongTypeFails() {
+        val profile = ChessBoardManager.createCurvatureProfile(width, height, radius)
+        val map = ChessBoardManager.generateCurvatureMapHandle(width, height, radius)
+        try {
+            assertEquals(0L, ChessBoardManager.nativeMatAddr(profile))
+            assertNull(ChessBoardManager.curvatureProfileRow(map))
+            assertNotEquals(0L, ChessBoardManager.nativeMatAddr(map))
+        } finally {
+            ChessBoardManager.releaseNative(profile)
+            ChessBoardManager.releaseNative(map)
+        }
+    }
+
+    @Test
+    fun reusedSlotGetsANewGeneration() {
+        val first = ChessBoardManager.createCurvatureProfile(width, height, radius)
+        ChessBoardManager.releaseNative(first)
+        val second = ChessBoardManager.createCurvatureProfile(width, height, radius)
+        try {
+            assertNotEquals(first, second)
+            assertNull(ChessBoardManager.curvatureProfileRow(first))
+            assertFalse(ChessBoardManager.releaseNative(first))
+            assertNotNull(ChessBoardManager.curvatureProfileRow(second))
+        } finally {
+            ChessBoardManager.releaseNative(second)
+        }
+    }
+
+    @Test
+    fun bytesAreAccountedPerType() {
+        val type = ChessBoardManager.HANDLE_CURVATURE_PROFILE
+        val baseBytes = bytes(type)
+        val baseCount = count(type)
+        val baseMatBytes = bytes(ChessBoardManager.HANDLE_MAT)
+
+        val handle = ChessBoardManager.createCurvatureProfile(width, height, radius)
+        assertEquals(baseCount + 1, count(type))
+        assertEquals(baseBytes + width * 4L, bytes(type))
+
+        // The dense map is built lazily; accounting follows the object as it grows.
+        ChessBoardManager.curvatureProfileDense(handle)
+        assertEquals(baseBytes + width * 4L + width * height * 4L, bytes(type))
+        assertEquals(baseMatBytes, bytes(ChessBoardManager.HANDLE_MAT))
+
+        ChessBoardManager.releaseNative(handle)
+        assertEquals(baseCount, count(type))
+        assertEquals(baseBytes, bytes(type))
+    }
+}
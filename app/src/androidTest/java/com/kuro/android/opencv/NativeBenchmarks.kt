@@ -0,0 +1,95 @@
+package com.kuro.android.opencv
+
+/**
+ * Benchmark-only natives, kept out of [ChessBoardManager] so that it holds only
+ * real entry points. This class ships in the instrumentation APK only; the
+ * native side is compiled into debug builds and bound by JNI_OnLoad when the
+ * class is present.
+ */
+object NativeBenchmarks {
+    init {
+        System.loadLibrary("opencv_java4")
+        System.loadLibrary("generate_chessboard")
+    }
+
+    /**
+     * Compares cornerSubPix with the saddle-point engine on a synthetic board.
+     * Returns [initialRms, subPixRms, subPixMs, saddleRms, saddleMs].
+     */
+    external fun benchmarkRefineEngines(
+        width: Int = 1280,
+        height: Int = 720,
+        cols: Int = 9,
+        rows: Int = 6,
+        noiseSigma: Float = 2f,
+        iterations: Int = 10,
+        seed: Long = 1L
+    ): FloatArray
+
+    /**
+     * Times [PredistortStream] on this device (default 4K RGBA): returns
+     * [msPerFrame, framesPerSecond, threads]. Sustaining 60 fps needs
+     * msPerFrame below 16.7 with headroom for upload or encoding.
+     */
+    external fun benchmarkPredistortStream(
+        width: Int = 3840,
+        height: Int = 2160,
+        radiusPx: Float = 3000f,
+        interpolation: Int = ChessBoardManager.WARP_LINEAR,
+        frames: Int = 120
+    ): FloatArray?
+
+    /**
+     * Times the row resampler against remap with cached CV_16SC2 maps on the
+     * same smooth RGBA frame (default 1080p). Returns [rowMs, remapMs,
+     * speedup, maxAbsDiff], maxAbsDiff in gray levels.
+     */
+    external fun benchmarkRowResampler(
+        width: Int = 1920,
+        height: Int = 1080,
+        radiusPx: Float = 1500f,
+        interpolation: Int = ChessBoardManager.WARP_LINEAR,
+        inverse: Boolean = false,
+        iterations: Int = 20
+    ): FloatArray?
+
+    /**
+     * Times the JNI binding layer. Bitmap creation through per-call
+     * class/method/field lookups versus the references cached in JNI_OnLoad
+     * (both create a real Bitmap), and the RegisterNatives call at load versus
+     * resolving the same natives by symbol lookup. Returns
+     * [uncachedNsPerBitmap, cachedNsPerBitmap, registerNativesUs, symbolLookupUs].
+     */
+    external fun benchmarkJniBinding(iterations: Int = 1_000): FloatArray
+
+    private external fun nativeDispatchProbe()
+
+    /** Not in the RegisterNatives table: the runtime binds it by symbol lookup. */
+    private external fun nativeDispatchProbeUnregistered()
+
+    /**
+     * Times an empty native bound by RegisterNatives against one the runtime
+     * binds by symbol lookup. Returns [registeredFirstCallNs,
+     * unregisteredFirstCallNs, registeredNsPerCall, unregisteredNsPerCall].
+     * The first-call numbers include the lazy lookup only on the first run in a
+     * process; later runs measure already bound methods.
+     */
+    fun benchmarkNativeDispatch(iterations: Int = 100_000): FloatArray {
+        val n = iterations.coerceAtLeast(1)
+        var t0 = System.nanoTime()
+        nativeDispatchProbe()
+        val registeredFirst = System.nanoTime() - t0
+        t0 = System.nanoTime()
+        nativeDispatchProbeUnregistered()
+        val unregisteredFirst = System.nanoTime() - t0
+
+        t0 = System.nanoTime()
+        repeat(n) { nativeDispatchProbe() }
+        val registered = (System.nanoTime() - t0).toFloat() / n
+        t0 = System.nanoTime()
+        repeat(n) { nativeDispatchProbeUnregistered() }
+        val unregistered = (System.nanoTime() - t0).toFloat() / n
+
+        return floatArrayOf(registeredFirst.toFloat(), unregisteredFirst.toFloat(), registered, unregistered)
+    }
+}
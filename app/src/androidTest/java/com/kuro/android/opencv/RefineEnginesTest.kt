@@ -0,0 +1,45 @@
+package com.kuro.android.opencv
+
+import android.util.Log
+import androidx.test.ext.junit.runners.AndroidJUnit4
+
+import org.junit.Test
+import org.junit.runner.RunWith
+
+import org.junit.Assert.*
+
+/**
+ * Saddle-point refinement against cornerSubPix on the synthetic board of
+ * benchmarkRefineEngines, whose inner corners are known to 1/8 px.
+ */
+@RunWith(AndroidJUnit4::class)
+class RefineEnginesTest {
+
+    private fun run(noiseSigma: Float, seed: Long): FloatArray {
+        val r = NativeBenchmarks.benchmarkRefineEngines(noiseSigma = noiseSigma, iterations = 3, seed = seed)
+        Log.i(TAG, "noise=$noiseSigma seed=$seed: initial ${r[0]} px | subpix ${r[1]} px ${r[2]} ms | " +
+                "saddle ${r[3]} px ${r[4]} ms")
+        return r
+    }
+
+    @Test
+    fun saddleIsAtLeastAsAccurateAsCornerSubPix() {
+        for (noise in floatArrayOf(0f, 2f)) {
+            for (seed in 1L..3L) {
+                val r = run(noise, seed)
+                assertTrue("saddle ${r[3]} px > subpix ${r[1]} px (noise $noise, seed $seed)", r[3] <= r[1])
+            }
+        }
+    }
+
+    @Test
+    fun bothEnginesImproveOnTheStartingPoints() {
+        val r = run(2f, 1L)
+        assertTrue(r[1] < r[0])
+        assertTrue(r[3] < r[0])
+    }
+
+    private companion object {
+        const val TAG = "RefineEnginesTest"
+    }
+}
@@ -0,0 +1,46 @@
+package com.kuro.android.opencv
+
+import android.util.Log
+import androidx.test.ext.junit.runners.AndroidJUnit4
+
+import org.junit.Test
+import org.junit.runner.RunWith
+
+import org.junit.Assert.*
+
+/**
+ * Row resampler against remap with cached CV_16SC2 maps, on a smooth 1080p
+ * RGBA frame. remap quantizes source positions to 1/32 px while the row
+ * tables keep exact float weights, so 8-bit results may differ by one gray
+ * level when flattening and by a few levels near the arc edges when
+ * pre-distorting, where the source position moves fastest.
+ */
+@RunWith(AndroidJUnit4::class)
+class RowResamplerTest {
+
+    private fun run(interpolation: Int, inverse: Boolean): FloatArray {
+        val r = checkNotNull(NativeBenchmarks.benchmarkRowResampler(
+            interpolation = interpolation, inverse = inverse))
+        Log.i(TAG, "interp=$interpolation inverse=$inverse: row ${r[0]} ms, remap ${r[1]} ms, " +
+                "speedup x${r[2]}, max diff ${r[3]}")
+        return r
+    }
+
+    @Test
+    fun flattenMatchesRemapWithinOneLevel() {
+        for (interpolation in intArrayOf(ChessBoardManager.WARP_LINEAR, ChessBoardManager.WARP_CUBIC)) {
+            assertTrue(run(interpolation, inverse = false)[3] <= 1f)
+        }
+    }
+
+    @Test
+    fun predistortMatchesRemapWithinThreeLevels() {
+        for (interpolation in intArrayOf(ChessBoardManager.WARP_LINEAR, ChessBoardManager.WARP_CUBIC)) {
+            assertTrue(run(interpolation, inverse = true)[3] <= 3f)
+        }
+    }
+
+    private companion object {
+        const val TAG = "RowResamplerTest"
+    }
+}
@@ -0,0 +1,80 @@
+#include "bitmap_pool.h"
+#include "jni_bindings.h"
+
+#include <android/bitmap.h>
+
+BitmapPool &BitmapPool::instance() {
+    static BitmapPool pool;
+    return pool;
+}
+
+jobject BitmapPool::acquire(JNIEnv *env, int width, int height) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = idle_.size(); i-- > 0;) {
+            const Entry &e = idle_[i];
+            if (e.width != width || e.height != height || e.format != ANDROID_BITMAP_FORMAT_RGBA_8888)
+                continue;
+            jobject bitmap = env->NewLocalRef(e.bitmap);
+            env->DeleteGlobalRef(e.bitmap);
+            bytes_ -= e.bytes;
+            idle_.erase(idle_.begin() + (long) i);
+            ++hits_;
+            return bitmap;
+        }
+        ++misses_;
+    }
+    return newArgbBitmap(env, width, height);
+}
+
+bool BitmapPool::recycle(JNIEnv *env, jobject bitmap) {
+    AndroidBitmapInfo info;
+    if (bitmap == nullptr || AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS)
+        return false;
+    const size_t bytes = (size_t) info.stride * info.height;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry &e : idle_)
+        if (env->IsSameObject(e.bitmap, bitmap)) return true; // already pooled
+
+    if (bytes > capacity_) {
+        ++dropped_;
+        return false;
+    }
+    trimTo(env, capacity_ - bytes);
+    idle_.push_back({(int) info.width, (int) info.height, info.format, bytes, env->NewGlobalRef(bitmap)});
+    bytes_ += bytes;
+    ++recycled_;
+    return true;
+}
+
+void BitmapPool::trimTo(JNIEnv *env, size_t budget) {
+    // Oldest first: the recently recycled sizes are the ones a layout reuses.
+    size_t n = 0;
+    while (n < idle_.size() && bytes_ > budget) {
+        env->DeleteGlobalRef(idle_[n].bitmap);
+        bytes_ -= idle_[n].bytes;
+        ++dropped_;
+        ++n;
+    }
+    idle_.erase(idle_.begin(), idle_.begin() + (long) n);
+}
+
+void BitmapPool::setCapacity(JNIEnv *env, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = bytes;
+    trimTo(env, capacity_);
+}
+
+void BitmapPool::clear(JNIEnv *env) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry &e : idle_) env->DeleteGlobalRef(e.bitmap);
+    idle_.clear();
+    bytes_ = 0;
+}
+
+BitmapPoolStats BitmapPool::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {hits_, misses_, recycled_, dropped_, (int64_t) idle_.size(),
+            (int64_t) bytes_, (int64_t) capacity_};
+}
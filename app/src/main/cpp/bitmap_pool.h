@@ -0,0 +1,70 @@
+#ifndef BITMAP_POOL_H
+#define BITMAP_POOL_H
+
+#include <jni.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/** Counters reported by BitmapPool::stats(). */
+struct BitmapPoolStats {
+    int64_t hits;
+    int64_t misses;
+    int64_t recycled;
+    int64_t dropped;
+    int64_t pooled;
+    int64_t bytes;
+    int64_t capacityBytes;
+};
+
+/**
+ * Process-wide pool of reusable Java Bitmaps, keyed by width, height and
+ * pixel format.
+ *
+ * Idle bitmaps are kept as global refs. acquire() hands one back as a local
+ * ref (creating an ARGB_8888 bitmap only on a miss); recycle() returns it.
+ * Combined with the generate*Into entry points, regenerating a layout of the
+ * same size allocates nothing on the Java heap. Idle bytes are bounded by a
+ * budget; a bitmap recycled into a full pool is simply dropped for the GC.
+ * Thread-safe.
+ */
+class BitmapPool {
+public:
+    static BitmapPool &instance();
+
+    /** Returns a width x height RGBA_8888 bitmap, reused if one is idle. */
+    jobject acquire(JNIEnv *env, int width, int height);
+
+    /**
+     * Puts @p bitmap back in the pool. The caller must not draw into it any
+     * more. @return false if it is not a valid bitmap or the pool is full.
+     */
+    bool recycle(JNIEnv *env, jobject bitmap);
+
+    void setCapacity(JNIEnv *env, size_t bytes);
+    void clear(JNIEnv *env);
+    BitmapPoolStats stats();
+
+private:
+    struct Entry {
+        int width;
+        int height;
+        int32_t format;
+        size_t bytes;
+        jobject bitmap; // global ref
+    };
+
+    BitmapPool() = default;
+    void trimTo(JNIEnv *env, size_t budget);
+
+    std::mutex mutex_;
+    std::vector<Entry> idle_; // most recently recycled last
+    size_t bytes_ = 0;
+    size_t capacity_ = 64u << 20;
+    int64_t hits_ = 0;
+    int64_t misses_ = 0;
+    int64_t recycled_ = 0;
+    int64_t dropped_ = 0;
+};
+
+#endif // BITMAP_POOL_H
@@ -0,0 +1,144 @@
+#include "calibration_session.h"
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "corner_refine.h"
+#include "curvature_fit.h"
+#include "mat_allocator.h"
+#include "trace_spans.h"
+
+using namespace cv;
+
+void ScratchArena::reserve(size_t bytes) {
+    if (bytes <= block_.size()) return;
+    block_.resize(bytes);
+    block_.shrink_to_fit();
+    used_ = 0;
+    ++growths_;
+}
+
+CalibrationSession::CalibrationSession(int cols, int rows)
+        : cols_(cols), rows_(rows) {
+    corners_.reserve((size_t) cols * rows);
+
+    // Per-frame arrays have a fixed size for a given grid, so one reservation lasts the session.
+    arena_.reserve(ScratchArena::footprint<QuadraticFit>(rows) +
+                   ScratchArena::footprint<QuadraticFit>(cols) +
+                   ScratchArena::footprint<float>(curvatureResultFloats(cols, rows)));
+}
+
+void CalibrationSession::ensure(Mat &m, Size size, int type) {
+    if (m.size() == size && m.type() == type) return;
+    m.create(size, type);
+    ++allocations_;
+}
+
+float CalibrationSession::detect(const Mat &img, int refineMode, int fitMode, const float **packed) {
+    ++frames_;
+    arena_.reset();
+    auto *rowFits = arena_.alloc<QuadraticFit>(rows_);
+    auto *colFits = arena_.alloc<QuadraticFit>(cols_);
+    auto *out = arena_.alloc<float>(curvatureResultFloats(cols_, rows_));
+    *packed = out;
+
+    // --- 1️⃣ Grayscale into the pooled buffer (single-channel input is used as is)
+    TRACE_STAGE("cvtColor");
+    MemoryStageScope memStage(MEM_STAGE_CONVERT);
+    const Mat *gray = &img;
+    if (img.channels() != 1) {
+        ensure(gray_, img.size(), CV_8UC1);
+        cvtColor(img, gray_, img.channels() == 4 ? COLOR_RGBA2GRAY : COLOR_BGR2GRAY);
+        gray = &gray_;
+    }
+
+    // --- 2️⃣ Find and refine corners into the reserved corner vector
+    TRACE_NEXT("findChessboardCorners");
+    memStage.enter(MEM_STAGE_DETECT);
+    bool found = findChessboardCorners(*gray, Size(cols_, rows_), corners_,
+                                       CALIB_CB_ADAPTIVE_THRESH + CALIB_CB_NORMALIZE_IMAGE);
+    double meanRadius = -1.0;
+    if (found) {
+        TRACE_NEXT("refineCorners");
+        memStage.enter(MEM_STAGE_REFINE);
+        TermCriteria subPixCriteria(TermCriteria::EPS + TermCriteria::MAX_ITER, 30, 0.1);
+        if (refineMode == REFINE_SADDLE)
+            refineCornersSaddle(*gray, corners_);
+        else if (refineMode == REFINE_SUBPIX_COARSE_TO_FINE)
+            refineCornersCoarseToFine(*gray, corners_, Size(11, 11), Size(-1, -1), subPixCriteria, &refine_);
+        else
+            refineCornersParallel(*gray, corners_, Size(11, 11), Size(-1, -1), subPixCriteria);
+
+        // --- 3️⃣ Row and column fits into the arena
+        TRACE_NEXT("fit");
+        memStage.enter(MEM_STAGE_FIT);
+        RobustFitParams fitParams;
+        fitParams.mode = fitMode;
+        fitGridQuadraticsRobust(corners_.data(), cols_, rows_, fitParams, rowFits, colFits);
+
+        double radiusSum = 0.0;
+        int radiusCount = 0;
+        for (int r = 0; r < rows_; ++r) {
+            const double radius = radiusFromQuadratic(rowFits[r]);
+            if (radius > 0.0) {
+                radiusSum += radius;
+                ++radiusCount;
+            }
+        }
+        if (radiusCount > 0) meanRadius = radiusSum / radiusCount;
+    } else {
+        corners_.clear();
+    }
+
+    packCurvatureResult(out, found, meanRadius,
+                        found ? rowFits : nullptr, rows_,
+                        found ? colFits : nullptr, cols_);
+    return static_cast<float>(meanRadius);
+}
+
+bool CalibrationSession::warpInPlace(Mat &mat, float radius, int interpolation, bool inverse,
+                                     bool bandParallel) {
+    if (mat.empty() || radius <= 0.f) return false;
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    if (interpolation != INTER_CUBIC) interpolation = INTER_LINEAR;
+
+    if (!isRowResampleSupported(mat.depth())) {
+        if (inverse) return false;
+        // Other depths go through remap with shared fixed-point maps and the pooled scratch frame.
+        Mat map1, map2;
+        FlattenMapCache::instance().get({mat.cols, mat.rows, radius, 0.0f,
+                                         interpolation, BORDER_CONSTANT}, map1, map2);
+        ensure(warpScratch_, mat.size(), mat.type());
+        mat.copyTo(warpScratch_);
+        TRACE_SCOPE("remap");
+        remap(warpScratch_, mat, map1, map2, interpolation, BORDER_CONSTANT, Scalar::all(0));
+        return true;
+    }
+
+    if (table_.width != mat.cols || table_.channels != mat.channels() || tableRadius_ != radius ||
+        tableInterpolation_ != interpolation || tableInverse_ != inverse) {
+        buildCylinderResampleTable(mat.cols, mat.channels(), radius, interpolation, table_, inverse);
+        tableRadius_ = radius;
+        tableInterpolation_ = interpolation;
+        tableInverse_ = inverse;
+        ++mapBuilds_;
+    }
+    resampleRowsInPlace(mat, table_, bandParallel);
+    return true;
+}
+
+size_t CalibrationSession::bytes() const {
+    size_t total = gray_.total() * gray_.elemSize() + warpScratch_.total() * warpScratch_.elemSize() +
+                   refine_.half.total() * refine_.half.elemSize() +
+                   (refine_.coarse.capacity() + refine_.settled.capacity() + refine_.active.capacity()) * sizeof(Point2f) +
+                   (refine_.settledIdx.capacity() + refine_.activeIdx.capacity()) * sizeof(int) +
+                   arena_.capacity() + corners_.capacity() * sizeof(Point2f) +
+                   table_.offsets.capacity() * sizeof(int) + table_.weights.capacity() * sizeof(float);
+    for (const auto &p : patterns_) total += p.second.total() * p.second.elemSize();
+    return total;
+}
+
+CalibrationSessionStats CalibrationSession::stats() const {
+    return {frames_, allocations_ + arena_.growths(), mapBuilds_, patternBuilds_,
+            (int64_t) arena_.capacity(), (int64_t) bytes()};
+}
@@ -0,0 +1,170 @@
+#ifndef CALIBRATION_SESSION_H
+#define CALIBRATION_SESSION_H
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include "corner_refine.h"
+#include "flatten_warp.h"
+
+/**
+ * Bump allocator over one block. Everything allocated during a frame is
+ * released at once by reset(); the block is sized once from the first
+ * frame's requirement and only grows if a later frame needs more.
+ */
+class ScratchArena {
+public:
+    static const size_t kAlign = 64; // cache line, also enough for any SIMD load
+    /** Bytes to reserve for one alloc<T>(count), alignment slack included. */
+    template <typename T>
+    static size_t footprint(size_t count) { return count * sizeof(T) + kAlign; }
+
+    /** Makes sure @p bytes fit after reset(); invalidates earlier allocations if it grows. */
+    void reserve(size_t bytes);
+
+    template <typename T>
+    T *alloc(size_t count) {
+        uchar *base = block_.data();
+        uchar *p = cv::alignPtr(base + used_, (int) kAlign);
+        const size_t end = (size_t) (p - base) + count * sizeof(T);
+        CV_Assert(end <= block_.size());
+        used_ = end;
+        highWater_ = std::max(highWater_, used_);
+        return reinterpret_cast<T *>(p);
+    }
+
+    void reset() { used_ = 0; }
+    size_t capacity() const { return block_.size(); }
+    size_t highWater() const { return highWater_; }
+    int growths() const { return growths_; }
+
+private:
+    std::vector<uchar> block_;
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+    int growths_ = 0;
+};
+
+/** Parameters of generateChessBoardGroupWithBlackPad, in declaration order. */
+typedef std::array<int, 12> PatternKey;
+
+/** Counters reported by CalibrationSession::stats(). */
+struct CalibrationSessionStats {
+    int64_t frames;       // detect() calls
+    int64_t allocations;  // Mat pool reallocations and arena growths
+    int64_t mapBuilds;
+    int64_t patternBuilds;
+    int64_t arenaBytes;
+    int64_t bytes;        // total held, see bytes()
+};
+
+/**
+ * Long-lived calibration state for one chessboard geometry.
+ *
+ * The stateless entry points allocate a gray image, the corner vector, fit
+ * arrays and warp tables on every call. A session owns all of them instead:
+ *  - a Mat buffer pool (gray frame, remap scratch, refinement pyramid) sized
+ *    from the first frame and reallocated only if the frame size or type changes;
+ *  - a scratch arena for the per-frame fit and packed-result arrays;
+ *  - the cylinder gather table of the last warp, rebuilt only when the width,
+ *    channels, radius or interpolation change;
+ *  - a small cache of rendered layout patterns.
+ * After the first frame the session's own buffers are reused, and stats()
+ * counts only their (re)allocations. Temporaries inside OpenCV
+ * (findChessboardCorners, cornerSubPix) and the saddle refiner's per-worker
+ * patches are still allocated every frame and are not seen by stats(); the
+ * per-stage mallocs counters of getMemoryStats (mat_allocator.h) show what a
+ * frame really allocates. Everything is freed when the session is released.
+ * Not thread-safe.
+ */
+class CalibrationSession {
+public:
+    CalibrationSession(int cols, int rows);
+
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+
+    /**
+     * Detects and refines the corners of @p img, fits every row and column
+     * and packs the result (see packCurvatureResult) into an arena buffer.
+     *
+     * @param packed Receives the arena buffer of curvatureResultFloats(cols, rows)
+     *               floats; valid until the next detect().
+     * @return       Mean row radius in pixels, -1 if detection or fitting failed.
+     */
+    float detect(const cv::Mat &img, int refineMode, int fitMode, const float **packed);
+
+    /** Corners found by the last successful detect(), row-major. */
+    const std::vector<cv::Point2f> &corners() const { return corners_; }
+
+    /**
+     * Cylindrical flatten (or, with @p inverse, pre-distortion) of @p mat in
+     * place, with the session's cached gather table.
+     * @return false for an empty Mat, a non-positive radius, or pre-distortion
+     *         of a depth the row resampler does not handle.
+     */
+    bool warpInPlace(cv::Mat &mat, float radius, int interpolation, bool inverse, bool bandParallel);
+
+    /**
+     * Returns the cached RGBA pattern for @p key, calling
+     * render(Mat &rgba) on a groupWidth x groupHeight CV_8UC4 canvas on a miss.
+     */
+    template <typename Render>
+    const cv::Mat &pattern(const PatternKey &key, Render &&render) {
+        for (auto it = patterns_.begin(); it != patterns_.end(); ++it) {
+            if (it->first != key) continue;
+            patterns_.splice(patterns_.begin(), patterns_, it);
+            return patterns_.front().second;
+        }
+        if ((int) patterns_.size() >= kMaxPatterns) {
+            patterns_.splice(patterns_.begin(), patterns_, std::prev(patterns_.end()));
+            patterns_.front().first = key; // recycle the least recently used canvas
+        } else {
+            patterns_.emplace_front(key, cv::Mat());
+        }
+        cv::Mat &canvas = patterns_.front().second;
+        // key[5] x key[4]: groupHeight x groupWidth
+        ensure(canvas, cv::Size(key[4], key[5]), CV_8UC4);
+        render(canvas);
+        ++patternBuilds_;
+        return canvas;
+    }
+
+    /** Bytes held by the pool, arena, tables, corners and cached patterns. */
+    size_t bytes() const;
+    CalibrationSessionStats stats() const;
+
+private:
+    static const int kMaxPatterns = 4;
+
+    /** Reallocates @p m only if its size or type differ. */
+    void ensure(cv::Mat &m, cv::Size size, int type);
+
+    int cols_, rows_;
+    int64_t frames_ = 0;
+    int64_t allocations_ = 0;
+    int64_t mapBuilds_ = 0;
+    int64_t patternBuilds_ = 0;
+
+    // Mat buffer pool
+    cv::Mat gray_;
+    cv::Mat warpScratch_;
+    RefineScratch refine_; // pyramid level and index lists of the coarse-to-fine refiner
+
+    ScratchArena arena_;
+    std::vector<cv::Point2f> corners_;
+
+    // Map cache: gather table of the last row warp and what it was built for
+    RowResampleTable table_;
+    float tableRadius_ = 0.f;
+    int tableInterpolation_ = -1;
+    bool tableInverse_ = false;
+
+    std::list<std::pair<PatternKey, cv::Mat>> patterns_; // most recently used first
+};
+
+#endif // CALIBRATION_SESSION_H
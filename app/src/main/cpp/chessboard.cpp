@@ -7,6 +7,20 @@
 #include <vector>
 #include <cmath>
 
+#include "bitmap_pool.h"
+#include "calibration_session.h"
+#include "corner_refine.h"
+#include "curvature_fit.h"
+#include "curvature_profile.h"
+#include "cylinder_fit.h"
+#include "flatten_warp.h"
+#include "jni_bindings.h"
+#include "mat_allocator.h"
+#include "mesh_warp.h"
+#include "native_registry.h"
+#include "stage_timer.h"
+#include "trace_spans.h"
+
 using namespace cv;
 using namespace std;
 
@@ -14,39 +28,18 @@ using namespace std;
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-/**
- * @brief Generates a chessboard pattern image and returns it as a Bitmap.
- *
- * @param env JNI environment pointer.
- * @param instance Java object reference (unused).
- * @param width Output image width in pixels.
- * @param height Output image height in pixels.
- * @param cols Number of chessboard columns.
- * @param rows Number of chessboard rows.
- * @param startX X-coordinate (top-left) where chessboard starts.
- * @param startY Y-coordinate (top-left) where chessboard starts.
- * @return Android Bitmap containing the generated chessboard.
- */
-extern "C"
-JNIEXPORT jobject JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoard(
-        JNIEnv *env,
-        jobject instance,
-        jint width,
-        jint height,
-        jint cols, jint rows,
-        jint startX,
-        jint startY
-) {
-    // Create a white canvas
-    Mat chessboard(height, width, CV_8UC3, Scalar(255, 255, 255));
+// Canvas colours in RGBA order, the layout of an ARGB_8888 Bitmap in memory.
+static const Scalar kWhite(255, 255, 255, 255);
+static const Scalar kBlack(0, 0, 0, 255);
 
+/** Draws the startX/startY-anchored chessboard into a CV_8UC4 canvas. */
+static void renderChessBoard(Mat &rgba, int cols, int rows, int startX, int startY) {
+    // White canvas
+    rgba.setTo(kWhite);
 
-    // Use the smaller side to ensure perfect squares (optional)
-    double cellWidth  = static_cast<double>(width  - startX) / cols;
-    double cellHeight = static_cast<double>(height - startY) / rows;
+    double cellWidth  = static_cast<double>(rgba.cols - startX) / cols;
+    double cellHeight = static_cast<double>(rgba.rows - startY) / rows;
 
-    // Draw the pattern
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
             if ((i + j) % 2 == 0) {
@@ -55,80 +48,17 @@ Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoard(
                 int x1 = static_cast<int>(startX + (j + 1) * cellWidth);
                 int y1 = static_cast<int>(startY + (i + 1) * cellHeight);
 
-                rectangle(chessboard, Point(x0, y0), Point(x1, y1),
-                          Scalar(0, 0, 0), FILLED);
+                rectangle(rgba, Point(x0, y0), Point(x1, y1), kBlack, FILLED);
             }
         }
     }
-
-    // Convert to RGBA for Android Bitmap
-    Mat rgba;
-    cvtColor(chessboard, rgba, COLOR_BGR2RGBA);
-
-    // ==== Create Android Bitmap ====
-    jclass bitmapCls = env->FindClass("android/graphics/Bitmap");
-    jmethodID createBitmapMID = env->GetStaticMethodID(
-            bitmapCls,
-            "createBitmap",
-            "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;"
-    );
-
-    jclass bitmapConfigCls = env->FindClass("android/graphics/Bitmap$Config");
-    jfieldID argb8888FID = env->GetStaticFieldID(
-            bitmapConfigCls,
-            "ARGB_8888",
-            "Landroid/graphics/Bitmap$Config;"
-    );
-
-    jobject argb8888Obj = env->GetStaticObjectField(bitmapConfigCls, argb8888FID);
-    jobject bitmap = env->CallStaticObjectMethod(
-            bitmapCls,
-            createBitmapMID,
-            width,
-            height,
-            argb8888Obj
-    );
-
-    // ==== Copy pixels to Bitmap ====
-    AndroidBitmapInfo info;
-    void *pixels = nullptr;
-    AndroidBitmap_getInfo(env, bitmap, &info);
-    AndroidBitmap_lockPixels(env, bitmap, &pixels);
-
-    memcpy(pixels, rgba.data, width * height * 4);
-    AndroidBitmap_unlockPixels(env, bitmap);
-
-    return bitmap;
 }
 
-
-/**
- * Generate a chessboard segment for a given cabinet group.
- * Each group knows its offset in the global layout.
- *
- * @param totalWidth  total combined width of all groups
- * @param totalHeight total height (should be same for all groups)
- * @param groupXOffset offset of this group (in pixels)
- * @param groupWidth  width of this group
- * @param groupHeight height of this group
- * @param cols total number of chessboard columns (across all groups)
- * @param rows total number of chessboard rows
- */
-extern "C"
-JNIEXPORT jobject JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroup(
-        JNIEnv *env,
-        jobject instance,
-        jint totalWidth,
-        jint totalHeight,
-        jint groupXOffset,
-        jint groupWidth,
-        jint groupHeight,
-        jint cols,
-        jint rows
-) {
-    // Create white canvas for this group
-    Mat chessboard(groupHeight, groupWidth, CV_8UC3, Scalar(255, 255, 255));
+/** Draws one group's slice of the global chessboard into a CV_8UC4 canvas. */
+static void renderChessBoardGroup(Mat &rgba, int totalWidth, int totalHeight, int groupXOffset,
+                                  int cols, int rows) {
+    const int groupWidth = rgba.cols;
+    rgba.setTo(kWhite);
 
     // Compute global cell sizes
     double cellWidth = static_cast<double>(totalWidth) / cols;
@@ -138,7 +68,6 @@ Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroup(
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
             if ((i + j) % 2 == 0) {
-                // Compute global coordinates
                 double gx0 = j * cellWidth;
                 double gx1 = (j + 1) * cellWidth;
                 double gy0 = i * cellHeight;
@@ -150,93 +79,27 @@ Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroup(
 
                 // Only draw if the cell intersects this group horizontally
                 if (localX1 > 0 && localX0 < groupWidth) {
-                    rectangle(chessboard,
+                    rectangle(rgba,
                               Point(static_cast<int>(localX0), static_cast<int>(gy0)),
                               Point(static_cast<int>(localX1), static_cast<int>(gy1)),
-                              Scalar(0, 0, 0), FILLED);
+                              kBlack, FILLED);
                 }
             }
         }
     }
-
-    // Convert to RGBA
-    Mat rgba;
-    cvtColor(chessboard, rgba, COLOR_BGR2RGBA);
-
-    // ==== Create Android Bitmap ====
-    jclass bitmapCls = env->FindClass("android/graphics/Bitmap");
-    jmethodID createBitmapMID = env->GetStaticMethodID(
-            bitmapCls,
-            "createBitmap",
-            "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;"
-    );
-
-    jclass bitmapConfigCls = env->FindClass("android/graphics/Bitmap$Config");
-    jfieldID argb8888FID = env->GetStaticFieldID(
-            bitmapConfigCls,
-            "ARGB_8888",
-            "Landroid/graphics/Bitmap$Config;"
-    );
-    jobject argb8888Obj = env->GetStaticObjectField(bitmapConfigCls, argb8888FID);
-
-    jobject bitmap = env->CallStaticObjectMethod(
-            bitmapCls, createBitmapMID, groupWidth, groupHeight, argb8888Obj
-    );
-
-    // Copy pixels
-    AndroidBitmapInfo info;
-    void *pixels = nullptr;
-    AndroidBitmap_getInfo(env, bitmap, &info);
-    AndroidBitmap_lockPixels(env, bitmap, &pixels);
-    memcpy(pixels, rgba.data, groupWidth * groupHeight * 4);
-    AndroidBitmap_unlockPixels(env, bitmap);
-
-    return bitmap;
 }
 
 /**
- * Generates a chessboard pattern for one LED group with black background.
- *
- * The generated bitmap represents a single group (cabinet cluster) within the
- * global LED wall layout. Only the active region (the physical LED area) is
- * filled with the chessboard pattern; all other areas remain black.
- *
- * @param env              JNI environment pointer.
- * @param instance         Java object calling this native method.
- * @param totalWidth       Total layout width (sum of all groups in global layout).
- * @param totalHeight      Total layout height (global layout height).
- * @param groupXOffset     Horizontal offset of this group in the global layout (pixels).
- * @param groupYOffset     Vertical offset of this group in the global layout (pixels).
- * @param groupWidth       Full canvas width of this group (pixels).
- * @param groupHeight      Full canvas height of this group (pixels).
- * @param activeXOffset    X offset (inside this group) where LED panels actually exist.
- * @param activeYOffset    Y offset (inside this group) where LED panels actually exist.
- * @param activeWidth      Width of the active LED region within the group.
- * @param activeHeight     Height of the active LED region within the group.
- * @param cols             Number of chessboard columns across the entire layout.
- * @param rows             Number of chessboard rows across the entire layout.
- * @return                 A Java Bitmap (ARGB_8888) containing the generated pattern.
+ * Draws one group's slice of the global chessboard into a CV_8UC4 canvas,
+ * restricted to the active LED region; everything else stays black.
  */
-extern "C"
-JNIEXPORT jobject JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackPad(
-        JNIEnv *env,
-        jobject instance,
-        jint totalWidth,
-        jint totalHeight,
-        jint groupXOffset,
-        jint groupYOffset,
-        jint groupWidth,
-        jint groupHeight,
-        jint activeXOffset,
-        jint activeYOffset,
-        jint activeWidth,
-        jint activeHeight,
-        jint cols,
-        jint rows
-) {
-    // --- 1️⃣ Create full black canvas for group
-    Mat chessboard(groupHeight, groupWidth, CV_8UC3, Scalar(0, 0, 0));
+static void renderChessBoardGroupWithBlackPad(Mat &rgba, int totalWidth, int totalHeight,
+                                              int groupXOffset, int groupYOffset,
+                                              int activeXOffset, int activeYOffset,
+                                              int activeWidth, int activeHeight,
+                                              int cols, int rows) {
+    // --- 1️⃣ Full black canvas for group
+    rgba.setTo(kBlack);
 
     // --- 2️⃣ Global cell size
     double cellWidth  = static_cast<double>(totalWidth) / cols;
@@ -266,340 +129,1902 @@ Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackP
                 // Only draw if overlap with active region
                 if (drawX1 > drawX0 && drawY1 > drawY0) {
                     rectangle(
-                            chessboard,
+                            rgba,
                             Point(static_cast<int>(drawX0), static_cast<int>(drawY0)),
                             Point(static_cast<int>(drawX1), static_cast<int>(drawY1)),
-                            Scalar(255, 255, 255),
+                            kWhite,
                             FILLED
                     );
                 }
             }
         }
     }
+}
 
-    // --- 4️⃣ Convert to RGBA
-    Mat rgba;
-    cvtColor(chessboard, rgba, COLOR_BGR2RGBA);
-
-    // --- 5️⃣ Create Android Bitmap
-    jclass bitmapCls = env->FindClass("android/graphics/Bitmap");
-    jmethodID createBitmapMID = env->GetStaticMethodID(
-            bitmapCls,
-            "createBitmap",
-            "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;"
-    );
-
-    jclass bitmapConfigCls = env->FindClass("android/graphics/Bitmap$Config");
-    jfieldID argb8888FID = env->GetStaticFieldID(
-            bitmapConfigCls,
-            "ARGB_8888",
-            "Landroid/graphics/Bitmap$Config;"
-    );
-    jobject argb8888Obj = env->GetStaticObjectField(bitmapConfigCls, argb8888FID);
-
-    jobject bitmap = env->CallStaticObjectMethod(
-            bitmapCls, createBitmapMID,
-            groupWidth, groupHeight, argb8888Obj
-    );
-
-    // --- 6️⃣ Copy pixels
+/**
+ * Locks @p bitmap, wraps its pixels as a CV_8UC4 Mat (honouring the row
+ * stride) and runs @p render on it, so patterns are drawn straight into the
+ * Bitmap without an intermediate canvas or copy.
+ *
+ * @return false (nothing drawn) unless the bitmap is RGBA_8888 and exactly
+ *         width x height.
+ */
+template <typename Render>
+static bool renderIntoBitmap(JNIEnv *env, jobject bitmap, int width, int height, Render &&render) {
     AndroidBitmapInfo info;
+    if (bitmap == nullptr || AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS)
+        return false;
+    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 ||
+        (int) info.width != width || (int) info.height != height ||
+        info.stride < info.width * 4) {
+        LOGE("Bitmap is %ux%u format %d, expected %dx%d RGBA_8888",
+             info.width, info.height, info.format, width, height);
+        return false;
+    }
+
     void *pixels = nullptr;
-    AndroidBitmap_getInfo(env, bitmap, &info);
-    AndroidBitmap_lockPixels(env, bitmap, &pixels);
-    memcpy(pixels, rgba.data, groupWidth * groupHeight * 4);
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS || pixels == nullptr)
+        return false;
+    TRACE_SCOPE("renderPattern");
+    MemoryStageScope memStage(MEM_STAGE_PATTERN);
+    Mat rgba(height, width, CV_8UC4, pixels, info.stride);
+    render(rgba);
     AndroidBitmap_unlockPixels(env, bitmap);
-
-    return bitmap;
+    return true;
 }
 
-
 /**
- * Detects the geometric curvature (bending) of a displayed chessboard pattern
- * within an image represented by a cv::Mat.
- *
- * Steps:
- *   1. Convert the image to grayscale.
- *   2. Detect chessboard corners (findChessboardCorners).
- *   3. Refine the corners for subpixel precision.
- *   4. Fit a 2nd-degree polynomial (y = ax² + bx + c) to each row of corners.
- *   5. Compute the curvature radius from the fitted "a" coefficient.
+ * @brief Generates a chessboard pattern image and returns it as a Bitmap.
  *
- * @param matPtr Address mat
- * @param cols   Number of chessboard inner corners horizontally.
- * @param rows   Number of chessboard inner corners vertically.
- * @param debug  If true, saves a debug image with drawn corners to /sdcard/Download/.
- * @return       Mean curvature radius in pixels (positive float). -1.0f if failed.
+ * @param env JNI environment pointer.
+ * @param instance Java object reference (unused).
+ * @param width Output image width in pixels.
+ * @param height Output image height in pixels.
+ * @param cols Number of chessboard columns.
+ * @param rows Number of chessboard rows.
+ * @param startX X-coordinate (top-left) where chessboard starts.
+ * @param startY Y-coordinate (top-left) where chessboard starts.
+ * @return Android Bitmap containing the generated chessboard.
  */
 extern "C"
-JNIEXPORT jfloat JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureFromMat(
+JNIEXPORT jobject JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoard(
         JNIEnv *env,
         jobject instance,
-        jlong matPtr,
-        int cols,
-        int rows,
-        jboolean debug
+        jint width,
+        jint height,
+        jint cols, jint rows,
+        jint startX,
+        jint startY
 ) {
-    cv::Mat &img = *(cv::Mat *)matPtr;
-    if (img.empty()) {
-        LOGE("Input Mat is empty!");
-        return -1.0f;
-    }
-
-    // 1️⃣ Convert to grayscale
-    Mat gray;
-    if (img.channels() == 3)
-        cvtColor(img, gray, COLOR_BGR2GRAY);
-    else if (img.channels() == 4)
-        cvtColor(img, gray, COLOR_RGBA2GRAY);
-    else
-        gray = img.clone();
-
-    // 2️⃣ Find chessboard corners
-    Size patternSize(cols, rows);
-    vector<Point2f> corners;
-    bool found = findChessboardCorners(gray, patternSize, corners,
-                                       CALIB_CB_ADAPTIVE_THRESH + CALIB_CB_NORMALIZE_IMAGE);
-
-    if (!found) {
-        LOGE("Chessboard not found in image.");
-        return -1.0f;
-    }
-
-    // 3️⃣ Refine detected corners
-    cornerSubPix(gray, corners, Size(11, 11), Size(-1, -1),
-                 TermCriteria(TermCriteria::EPS + TermCriteria::MAX_ITER, 30, 0.1));
-
-    // 4️⃣ (Optional) Debug visualization
-    if (debug) {
-        Mat vis = img.clone();
-        drawChessboardCorners(vis, patternSize, corners, found);
-        imwrite("/sdcard/Download/debug_chessboard_detected.jpg", vis);
-        LOGE("Saved debug chessboard overlay.");
-    }
-
-    // 5️⃣ Compute curvature along each row
-    vector<double> curvatures;
-    for (int r = 0; r < rows; ++r) {
-        vector<Point2f> rowPts;
-        for (int c = 0; c < cols; ++c)
-            rowPts.push_back(corners[r * cols + c]);
-
-        // Fit y = ax² + bx + c
-        int n = (int) rowPts.size();
-        if (n < 3) continue;
-
-        Mat A(n, 3, CV_64F);
-        Mat Y(n, 1, CV_64F);
-        for (int i = 0; i < n; ++i) {
-            A.at<double>(i, 0) = rowPts[i].x * rowPts[i].x;
-            A.at<double>(i, 1) = rowPts[i].x;
-            A.at<double>(i, 2) = 1.0;
-            Y.at<double>(i, 0) = rowPts[i].y;
-        }
-
-        Mat coef;
-        solve(A, Y, coef, DECOMP_NORMAL);
-
-        double a = coef.at<double>(0);
-        if (fabs(a) > 1e-9) {
-            double radius = 1.0 / (2.0 * fabs(a));
-            curvatures.push_back(radius);
-        }
-    }
-
-    if (curvatures.empty()) {
-        LOGE("No valid curvature rows detected.");
-        return -1.0f;
-    }
-
-    // 6️⃣ Compute mean curvature radius
-    double meanRadius = 0.0;
-    for (double r: curvatures) meanRadius += r;
-    meanRadius /= curvatures.size();
-
-    LOGE("Mean curvature radius = %.2f px", meanRadius);
-    return static_cast<float>(meanRadius);
+    TRACE_FUNCTION("generateChessBoard");
+    // Bitmap class, createBitmap and ARGB_8888 are resolved once in JNI_OnLoad.
+    jobject bitmap = newArgbBitmap(env, width, height);
+    renderIntoBitmap(env, bitmap, width, height, [&](Mat &rgba) {
+        renderChessBoard(rgba, cols, rows, startX, startY);
+    });
+    return bitmap;
 }
 
+/**
+ * Renders the pattern of generateChessBoard into an existing Bitmap (for
+ * example one from acquirePooledBitmap) instead of allocating a new one.
+ *
+ * @param bitmap Target, must be RGBA_8888 and exactly width x height.
+ * @return       false if the bitmap does not match; it is left untouched.
+ */
 extern "C"
-JNIEXPORT jfloat JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_pixelRadiusToMeters(
-        JNIEnv* env,
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardInto(
+        JNIEnv *env,
         jobject /*thiz*/,
-        jfloat radiusPx,
-        jfloat pixelPitchMM
+        jobject bitmap,
+        jint width,
+        jint height,
+        jint cols, jint rows,
+        jint startX,
+        jint startY
 ) {
-    /**
-     * Converts a curvature radius from pixels to meters.
-     *
-     * @param radiusPx       Radius of curvature in pixels.
-     * @param pixelPitchMM   Physical pixel pitch in millimeters.
-     * @return               Radius of curvature in meters.
-     */
-    if (radiusPx <= 0.0f) return -1.0f;
-    float radiusMeters = (radiusPx * pixelPitchMM) / 1000.0f;
-    return radiusMeters;
+    TRACE_FUNCTION("generateChessBoardInto");
+    return renderIntoBitmap(env, bitmap, width, height, [&](Mat &rgba) {
+        renderChessBoard(rgba, cols, rows, startX, startY);
+    });
 }
 
+/**
+ * Generate a chessboard segment for a given cabinet group.
+ * Each group knows its offset in the global layout.
+ *
+ * @param totalWidth  total combined width of all groups
+ * @param totalHeight total height (should be same for all groups)
+ * @param groupXOffset offset of this group (in pixels)
+ * @param groupWidth  width of this group
+ * @param groupHeight height of this group
+ * @param cols total number of chessboard columns (across all groups)
+ * @param rows total number of chessboard rows
+ */
 extern "C"
-JNIEXPORT jfloatArray JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfile(
-        JNIEnv* env,
-        jobject /*thiz*/,
-        jint width,
-        jfloat radiusPx
+JNIEXPORT jobject JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroup(
+        JNIEnv *env,
+        jobject instance,
+        jint totalWidth,
+        jint totalHeight,
+        jint groupXOffset,
+        jint groupWidth,
+        jint groupHeight,
+        jint cols,
+        jint rows
 ) {
+    TRACE_FUNCTION("generateChessBoardGroup");
+    // Bitmap class, createBitmap and ARGB_8888 are resolved once in JNI_OnLoad.
+    jobject bitmap = newArgbBitmap(env, groupWidth, groupHeight);
+    renderIntoBitmap(env, bitmap, groupWidth, groupHeight, [&](Mat &rgba) {
+        renderChessBoardGroup(rgba, totalWidth, totalHeight, groupXOffset, cols, rows);
+    });
+    return bitmap;
+}
+
+/** generateChessBoardGroup into an existing groupWidth x groupHeight RGBA_8888 Bitmap. */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupInto(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jobject bitmap,
+        jint totalWidth,
+        jint totalHeight,
+        jint groupXOffset,
+        jint groupWidth,
+        jint groupHeight,
+        jint cols,
+        jint rows
+) {
+    TRACE_FUNCTION("generateChessBoardGroupInto");
+    return renderIntoBitmap(env, bitmap, groupWidth, groupHeight, [&](Mat &rgba) {
+        renderChessBoardGroup(rgba, totalWidth, totalHeight, groupXOffset, cols, rows);
+    });
+}
+
+/**
+ * Generates a chessboard pattern for one LED group with black background.
+ *
+ * The generated bitmap represents a single group (cabinet cluster) within the
+ * global LED wall layout. Only the active region (the physical LED area) is
+ * filled with the chessboard pattern; all other areas remain black.
+ *
+ * @param env              JNI environment pointer.
+ * @param instance         Java object calling this native method.
+ * @param totalWidth       Total layout width (sum of all groups in global layout).
+ * @param totalHeight      Total layout height (global layout height).
+ * @param groupXOffset     Horizontal offset of this group in the global layout (pixels).
+ * @param groupYOffset     Vertical offset of this group in the global layout (pixels).
+ * @param groupWidth       Full canvas width of this group (pixels).
+ * @param groupHeight      Full canvas height of this group (pixels).
+ * @param activeXOffset    X offset (inside this group) where LED panels actually exist.
+ * @param activeYOffset    Y offset (inside this group) where LED panels actually exist.
+ * @param activeWidth      Width of the active LED region within the group.
+ * @param activeHeight     Height of the active LED region within the group.
+ * @param cols             Number of chessboard columns across the entire layout.
+ * @param rows             Number of chessboard rows across the entire layout.
+ * @return                 A Java Bitmap (ARGB_8888) containing the generated pattern.
+ */
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackPad(
+        JNIEnv *env,
+        jobject instance,
+        jint totalWidth,
+        jint totalHeight,
+        jint groupXOffset,
+        jint groupYOffset,
+        jint groupWidth,
+        jint groupHeight,
+        jint activeXOffset,
+        jint activeYOffset,
+        jint activeWidth,
+        jint activeHeight,
+        jint cols,
+        jint rows
+) {
+    TRACE_FUNCTION("generateChessBoardGroupWithBlackPad");
+    // Bitmap class, createBitmap and ARGB_8888 are resolved once in JNI_OnLoad.
+    jobject bitmap = newArgbBitmap(env, groupWidth, groupHeight);
+    renderIntoBitmap(env, bitmap, groupWidth, groupHeight, [&](Mat &rgba) {
+        renderChessBoardGroupWithBlackPad(rgba, totalWidth, totalHeight, groupXOffset, groupYOffset,
+                                          activeXOffset, activeYOffset, activeWidth, activeHeight,
+                                          cols, rows);
+    });
+    return bitmap;
+}
+
+/** generateChessBoardGroupWithBlackPad into an existing groupWidth x groupHeight RGBA_8888 Bitmap. */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackPadInto(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jobject bitmap,
+        jint totalWidth,
+        jint totalHeight,
+        jint groupXOffset,
+        jint groupYOffset,
+        jint groupWidth,
+        jint groupHeight,
+        jint activeXOffset,
+        jint activeYOffset,
+        jint activeWidth,
+        jint activeHeight,
+        jint cols,
+        jint rows
+) {
+    TRACE_FUNCTION("generateChessBoardGroupWithBlackPadInto");
+    return renderIntoBitmap(env, bitmap, groupWidth, groupHeight, [&](Mat &rgba) {
+        renderChessBoardGroupWithBlackPad(rgba, totalWidth, totalHeight, groupXOffset, groupYOffset,
+                                          activeXOffset, activeYOffset, activeWidth, activeHeight,
+                                          cols, rows);
+    });
+}
+
+/**
+ * Hands out a width x height ARGB_8888 Bitmap from the native pool, creating
+ * one only if no idle bitmap of that size is available. Pair with
+ * recyclePooledBitmap once the bitmap is no longer displayed.
+ */
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_acquirePooledBitmap(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jint width,
+        jint height
+) {
+    TRACE_FUNCTION("acquirePooledBitmap");
+    if (width <= 0 || height <= 0) return nullptr;
+    return BitmapPool::instance().acquire(env, width, height);
+}
+
+/** Returns @p bitmap to the pool; false if it was dropped instead. */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_recyclePooledBitmap(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jobject bitmap
+) {
+    TRACE_FUNCTION("recyclePooledBitmap");
+    return BitmapPool::instance().recycle(env, bitmap);
+}
+
+/**
+ * @return [hits, misses, recycled, dropped, pooled, bytes, capacityBytes]
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_getBitmapPoolStats(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("getBitmapPoolStats");
+    const BitmapPoolStats s = BitmapPool::instance().stats();
+    const jlong values[] = {s.hits, s.misses, s.recycled, s.dropped, s.pooled, s.bytes, s.capacityBytes};
+    jlongArray result = env->NewLongArray(7);
+    env->SetLongArrayRegion(result, 0, 7, values);
+    return result;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_setBitmapPoolCapacity(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong bytes
+) {
+    TRACE_FUNCTION("setBitmapPoolCapacity");
+    BitmapPool::instance().setCapacity(env, bytes > 0 ? (size_t) bytes : 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_clearBitmapPool(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("clearBitmapPool");
+    BitmapPool::instance().clear(env);
+}
+
+
+/**
+ * Releases @p handle only if it refers to a @p type object, so a type-specific
+ * release cannot free an unrelated object through a mixed-up handle.
+ */
+static void releaseTyped(jlong handle, HandleType type) {
+    if (HandleRegistry::instance().lookup(handle, type))
+        HandleRegistry::instance().release(handle);
+}
+
+/**
+ * Converts to grayscale, finds the chessboard and refines its inner corners.
+ *
+ * @param img        Input image (gray, BGR or RGBA).
+ * @param cols       Number of chessboard inner corners horizontally.
+ * @param rows       Number of chessboard inner corners vertically.
+ * @param debug      If true, saves a debug image with drawn corners to /sdcard/Download/.
+ * @param refineMode Sub-pixel refinement mode (see RefineMode in corner_refine.h).
+ * @param corners    Output row-major corner array of size cols·rows.
+ * @param timer      Optional; charged for the convert, search, refine and debug stages.
+ * @return           false if the chessboard was not found.
+ */
+static bool detectRefinedCorners(const Mat &img, int cols, int rows, bool debug,
+                                 int refineMode, vector<Point2f> &corners,
+                                 StageTimer *timer = nullptr) {
+    StageTimer untimed(nullptr);
+    StageTimer &clock = timer ? *timer : untimed;
+
+    // 1️⃣ Convert to grayscale
+    TRACE_STAGE("cvtColor");
+    MemoryStageScope memStage(MEM_STAGE_CONVERT);
+    Mat gray;
+    if (img.channels() == 3)
+        cvtColor(img, gray, COLOR_BGR2GRAY);
+    else if (img.channels() == 4)
+        cvtColor(img, gray, COLOR_RGBA2GRAY);
+    else
+        gray = img.clone();
+    clock.lap(TIMING_CONVERT);
+
+    // 2️⃣ Find chessboard corners
+    TRACE_NEXT("findChessboardCorners");
+    memStage.enter(MEM_STAGE_DETECT);
+    Size patternSize(cols, rows);
+    bool found = findChessboardCorners(gray, patternSize, corners,
+                                       CALIB_CB_ADAPTIVE_THRESH + CALIB_CB_NORMALIZE_IMAGE);
+    clock.lap(TIMING_SEARCH);
+
+    if (!found) {
+        LOGE("Chessboard not found in image.");
+        return false;
+    }
+
+    // 3️⃣ Refine detected corners
+    TRACE_NEXT("refineCorners");
+    memStage.enter(MEM_STAGE_REFINE);
+    TermCriteria subPixCriteria(TermCriteria::EPS + TermCriteria::MAX_ITER, 30, 0.1);
+    if (refineMode == REFINE_SADDLE)
+        refineCornersSaddle(gray, corners);
+    else if (refineMode == REFINE_SUBPIX_COARSE_TO_FINE)
+        refineCornersCoarseToFine(gray, corners, Size(11, 11), Size(-1, -1), subPixCriteria);
+    else
+        refineCornersParallel(gray, corners, Size(11, 11), Size(-1, -1), subPixCriteria);
+    clock.lap(TIMING_REFINE);
+
+    // 4️⃣ (Optional) Debug visualization
+    TRACE_NEXT("debugOverlay");
+    memStage.enter(MEM_STAGE_OTHER);
+    if (debug) {
+        Mat vis = img.clone();
+        drawChessboardCorners(vis, patternSize, corners, found);
+        imwrite("/sdcard/Download/debug_chessboard_detected.jpg", vis);
+        LOGE("Saved debug chessboard overlay.");
+    }
+    clock.lap(TIMING_DEBUG);
+    return true;
+}
+
+/**
+ * Averages the vertex radii 1 / (2|a|) of all valid row fits.
+ *
+ * @return Mean radius in pixels, or -1 if no row produced a usable fit.
+ */
+static double meanRowRadius(const QuadraticFit *rowFits, int rows) {
+    double radiusSum = 0.0;
+    int radiusCount = 0;
+    for (int r = 0; r < rows; ++r) {
+        double radius = radiusFromQuadratic(rowFits[r]);
+        if (radius > 0.0) {
+            radiusSum += radius;
+            ++radiusCount;
+        }
+    }
+
+    if (radiusCount == 0) {
+        LOGE("No valid curvature rows detected.");
+        return -1.0;
+    }
+    return radiusSum / radiusCount;
+}
+
+/**
+ * Runs detection and row/column fitting and packs the structured result
+ * (see packCurvatureResult in curvature_fit.h) into @p out.
+ *
+ * @return Mean curvature radius in pixels, -1 if detection or fitting failed.
+ */
+static float detectCurvatureInto(const Mat &img, int cols, int rows, bool debug,
+                                 int refineMode, int fitMode, float *out) {
+    AutoBuffer<QuadraticFit, 64> rowFits(rows);
+    AutoBuffer<QuadraticFit, 64> colFits(cols);
+    vector<Point2f> corners;
+
+    double meanRadius = -1.0;
+    bool found = !img.empty() && detectRefinedCorners(img, cols, rows, debug, refineMode, corners);
+    if (found) {
+        TRACE_SCOPE("fit");
+        MemoryStageScope memStage(MEM_STAGE_FIT);
+        RobustFitParams fitParams;
+        fitParams.mode = fitMode;
+        fitGridQuadraticsRobust(corners.data(), cols, rows, fitParams, rowFits.data(), colFits.data());
+        meanRadius = meanRowRadius(rowFits.data(), rows);
+    }
+
+    packCurvatureResult(out, found, meanRadius,
+                        found ? rowFits.data() : nullptr, rows,
+                        found ? colFits.data() : nullptr, cols);
+    return static_cast<float>(meanRadius);
+}
+
+/**
+ * Body of detectCurvatureFromMat: detection, row fits and the mean radius,
+ * with each stage charged to @p timer.
+ *
+ * @return Mean curvature radius in pixels, -1 if failed.
+ */
+static float detectMeanRadius(const Mat &img, int cols, int rows, bool debug,
+                              int refineMode, int fitMode, StageTimer &timer) {
+    if (img.empty()) {
+        LOGE("Input Mat is empty!");
+        return -1.0f;
+    }
+
+    vector<Point2f> corners;
+    if (!detectRefinedCorners(img, cols, rows, debug, refineMode, corners, &timer))
+        return -1.0f;
+
+    // 5️⃣ Compute curvature along each row (closed-form fits, no per-row Mats)
+    TRACE_SCOPE("fit");
+    MemoryStageScope memStage(MEM_STAGE_FIT);
+    AutoBuffer<QuadraticFit, 64> rowFits(rows);
+    RobustFitParams fitParams;
+    fitParams.mode = fitMode;
+    fitGridQuadraticsRobust(corners.data(), cols, rows, fitParams, rowFits.data(), nullptr);
+
+    // 6️⃣ Compute mean curvature radius
+    double meanRadius = meanRowRadius(rowFits.data(), rows);
+    timer.lap(TIMING_FIT);
+    if (meanRadius < 0.0)
+        return -1.0f;
+
+    LOGE("Mean curvature radius = %.2f px", meanRadius);
+    return static_cast<float>(meanRadius);
+}
+
+/**
+ * Detects the geometric curvature (bending) of a displayed chessboard pattern
+ * within an image represented by a cv::Mat.
+ *
+ * Steps:
+ *   1. Convert the image to grayscale.
+ *   2. Detect chessboard corners (findChessboardCorners).
+ *   3. Refine the corners for subpixel precision.
+ *   4. Fit a 2nd-degree polynomial (y = ax² + bx + c) to each row of corners.
+ *   5. Compute the curvature radius from the fitted "a" coefficient.
+ *
+ * @param matPtr Address mat
+ * @param cols   Number of chessboard inner corners horizontally.
+ * @param rows   Number of chessboard inner corners vertically.
+ * @param debug  If true, saves a debug image with drawn corners to /sdcard/Download/.
+ * @param refineMode Sub-pixel refinement mode (see RefineMode in corner_refine.h).
+ * @param fitMode    Row fitting mode (see FitMode in curvature_fit.h).
+ * @param timings    Optional long[TIMING_COUNT] receiving the time spent in each
+ *                   stage in nanoseconds (see DetectTiming in stage_timer.h);
+ *                   null skips timing entirely.
+ * @return       Mean curvature radius in pixels (positive float). -1.0f if failed.
+ */
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureFromMat(
+        JNIEnv *env,
+        jobject instance,
+        jlong matPtr,
+        int cols,
+        int rows,
+        jboolean debug,
+        jint refineMode,
+        jint fitMode,
+        jlongArray timings
+) {
+    TRACE_FUNCTION("detectCurvatureFromMat");
+    if (timings != nullptr && env->GetArrayLength(timings) < TIMING_COUNT) {
+        LOGE("Timing array must hold %d longs", (int) TIMING_COUNT);
+        return -1.0f;
+    }
+
+    int64_t stageNs[TIMING_COUNT] = {0};
+    StageTimer timer(timings != nullptr ? stageNs : nullptr);
+    const cv::Mat &img = *(cv::Mat *)matPtr;
+    const float radius = detectMeanRadius(img, cols, rows, debug, refineMode, fitMode, timer);
+    timer.finish();
+
+    if (timings != nullptr) {
+        // jlong is not int64_t on every ABI (long long vs long), so copy rather than alias.
+        jlong values[TIMING_COUNT];
+        std::copy(stageNs, stageNs + TIMING_COUNT, values);
+        env->SetLongArrayRegion(timings, 0, TIMING_COUNT, values);
+    }
+    return radius;
+}
+
+/**
+ * Same as detectCurvatureFromMat, but also writes per-row and per-column fits
+ * into a caller-provided float[] starting at @p offset.
+ *
+ * The packed layout is described by packCurvatureResult (curvature_fit.h) and
+ * mirrored by CurvatureResult.kt. The array must hold at least
+ * curvatureResultFloats(cols, rows) floats after @p offset.
+ *
+ * @return Mean curvature radius in pixels, -1.0f if failed.
+ */
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureIntoArray(
+        JNIEnv *env,
+        jobject instance,
+        jlong matPtr,
+        jint cols,
+        jint rows,
+        jfloatArray out,
+        jint offset,
+        jboolean debug,
+        jint refineMode,
+        jint fitMode
+) {
+    TRACE_FUNCTION("detectCurvatureIntoArray");
+    const int count = curvatureResultFloats(cols, rows);
+    if (out == nullptr || offset < 0 || env->GetArrayLength(out) - offset < count) {
+        LOGE("Result array too small: need %d floats at offset %d", count, offset);
+        return -1.0f;
+    }
+
+    AutoBuffer<float, 512> packed(count);
+    const cv::Mat &img = *(cv::Mat *) matPtr;
+    float meanRadius = detectCurvatureInto(img, cols, rows, debug, refineMode, fitMode,
+                                           packed.data());
+
+    env->SetFloatArrayRegion(out, offset, count, packed.data());
+    return meanRadius;
+}
+
+/**
+ * Same as detectCurvatureIntoArray, but writes straight into a direct
+ * ByteBuffer (native byte order), so nothing is copied through the JVM.
+ * Intended to be called repeatedly with the same buffer in live mode.
+ *
+ * @return Mean curvature radius in pixels, -1.0f if failed.
+ */
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureIntoBuffer(
+        JNIEnv *env,
+        jobject instance,
+        jlong matPtr,
+        jint cols,
+        jint rows,
+        jobject buffer,
+        jboolean debug,
+        jint refineMode,
+        jint fitMode
+) {
+    TRACE_FUNCTION("detectCurvatureIntoBuffer");
+    const int count = curvatureResultFloats(cols, rows);
+    auto *out = buffer ? static_cast<float *>(env->GetDirectBufferAddress(buffer)) : nullptr;
+    if (out == nullptr || env->GetDirectBufferCapacity(buffer) < (jlong) count * (jlong) sizeof(float)) {
+        LOGE("Result buffer must be direct and hold %d floats", count);
+        return -1.0f;
+    }
+
+    const cv::Mat &img = *(cv::Mat *) matPtr;
+    return detectCurvatureInto(img, cols, rows, debug, refineMode, fitMode, out);
+}
+
+/**
+ * Estimates one cylinder radius from all corners at once instead of averaging
+ * independent row parabolas (see fitCylinder in cylinder_fit.h).
+ *
+ * @param matPtr     Address of the input cv::Mat.
+ * @param cols       Number of chessboard inner corners horizontally.
+ * @param rows       Number of chessboard inner corners vertically.
+ * @param out        float[CYLINDER_RESULT_FLOATS] receiving the fitted model.
+ * @param warmStart  If true and @p out holds a converged fit (e.g. the previous
+ *                   live frame), the solver starts from it.
+ * @param refineMode Sub-pixel refinement mode (see RefineMode in corner_refine.h).
+ * @return           Cylinder radius in pixels, -1.0f if detection failed or the wall is flat.
+ */
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_detectCylinderFromMat(
+        JNIEnv *env,
+        jobject instance,
+        jlong matPtr,
+        jint cols,
+        jint rows,
+        jfloatArray out,
+        jboolean warmStart,
+        jint refineMode
+) {
+    TRACE_FUNCTION("detectCylinderFromMat");
+    if (out == nullptr || env->GetArrayLength(out) < CYLINDER_RESULT_FLOATS) {
+        LOGE("Cylinder result array must hold %d floats", CYLINDER_RESULT_FLOATS);
+        return -1.0f;
+    }
+
+    cv::Mat &img = *(cv::Mat *) matPtr;
+    if (img.empty()) {
+        LOGE("Input Mat is empty!");
+        return -1.0f;
+    }
+
+    vector<Point2f> corners;
+    if (!detectRefinedCorners(img, cols, rows, false, refineMode, corners))
+        return -1.0f;
+
+    float packed[CYLINDER_RESULT_FLOATS];
+    CylinderFit fit = CylinderFit();
+    if (warmStart) {
+        env->GetFloatArrayRegion(out, 0, CYLINDER_RESULT_FLOATS, packed);
+        unpackCylinderFit(packed, fit);
+    }
+
+    TRACE_SCOPE("fit");
+    MemoryStageScope memStage(MEM_STAGE_FIT);
+    if (!fitCylinder(corners.data(), cols, rows, fit, 50, warmStart)) {
+        LOGE("Cylinder fit failed.");
+        return -1.0f;
+    }
+
+    packCylinderFit(fit, packed);
+    env->SetFloatArrayRegion(out, 0, CYLINDER_RESULT_FLOATS, packed);
+
+    LOGI("Cylinder radius = %.2f ± %.2f px (rms %.3f px, %d iterations)",
+         fit.radius, fit.radiusStd, fit.rmsError, fit.iterations);
+    return static_cast<float>(fit.radius);
+}
+
+/**
+ * Fits a piecewise-radius (segmented) curvature model for walls assembled from
+ * cabinets with different lock angles (see fitSegmentedCurvature in curvature_fit.h).
+ *
+ * @param matPtr     Address of the input cv::Mat.
+ * @param cols       Number of chessboard inner corners horizontally.
+ * @param rows       Number of chessboard inner corners vertically.
+ * @param boundaries Allowed breakpoints as corner-column indices (cabinet edges), or null for any.
+ * @param out        Receives 4 floats per segment: startCol, endCol, signed radius (px), rms (px).
+ *                   Its length / 4 bounds the number of segments reported.
+ * @param penalty    Per-segment penalty in px²; <= 0 picks one from the measured noise.
+ * @param refineMode Sub-pixel refinement mode (see RefineMode in corner_refine.h).
+ * @return           Number of segments written, -1 if detection failed.
+ */
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_detectSegmentedCurvature(
+        JNIEnv *env,
+        jobject instance,
+        jlong matPtr,
+        jint cols,
+        jint rows,
+        jintArray boundaries,
+        jfloatArray out,
+        jfloat penalty,
+        jint refineMode
+) {
+    TRACE_FUNCTION("detectSegmentedCurvature");
+    const int maxSegments = out ? env->GetArrayLength(out) / 4 : 0;
+    if (maxSegments == 0) {
+        LOGE("Segment output array must hold at least 4 floats");
+        return -1;
+    }
+
+    cv::Mat &img = *(cv::Mat *) matPtr;
+    if (img.empty()) {
+        LOGE("Input Mat is empty!");
+        return -1;
+    }
+
+    vector<Point2f> corners;
+    if (!detectRefinedCorners(img, cols, rows, false, refineMode, corners))
+        return -1;
+
+    vector<jint> breaks;
+    if (boundaries) {
+        breaks.resize(env->GetArrayLength(boundaries));
+        env->GetIntArrayRegion(boundaries, 0, (jsize) breaks.size(), breaks.data());
+    }
+
+    TRACE_SCOPE("fit");
+    MemoryStageScope memStage(MEM_STAGE_FIT);
+    AutoBuffer<CurvatureSegment, 16> segments(maxSegments);
+    int count = fitSegmentedCurvature(corners.data(), cols, rows,
+                                      boundaries ? breaks.data() : nullptr, (int) breaks.size(),
+                                      penalty, segments.data(), maxSegments);
+
+    AutoBuffer<float, 64> packed(4 * std::max(count, 1));
+    for (int k = 0; k < count; ++k) {
+        packed[4 * k + 0] = (float) segments[k].startCol;
+        packed[4 * k + 1] = (float) segments[k].endCol;
+        packed[4 * k + 2] = (float) segments[k].radius;
+        packed[4 * k + 3] = (float) segments[k].rmsResidual;
+        LOGI("Segment %d: columns [%d, %d) radius %.2f px", k,
+             segments[k].startCol, segments[k].endCol, segments[k].radius);
+    }
+    if (count > 0) env->SetFloatArrayRegion(out, 0, 4 * count, packed.data());
+    return count;
+}
+
+/**
+ * Estimates horizontal and vertical radii for dome/barrel walls from a quadric
+ * surface fitted to all corners (see fitQuadricSurface in curvature_fit.h).
+ *
+ * @param matPtr     Address of the input cv::Mat.
+ * @param cols       Number of chessboard inner corners horizontally.
+ * @param rows       Number of chessboard inner corners vertically.
+ * @param out        float[15]: horizontal radius, vertical radius, rms (all px),
+ *                   then the six x and six y surface coefficients.
+ * @param refineMode Sub-pixel refinement mode (see RefineMode in corner_refine.h).
+ * @return           true if the board was found and the surface fitted.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_detectSurfaceCurvature(
+        JNIEnv *env,
+        jobject instance,
+        jlong matPtr,
+        jint cols,
+        jint rows,
+        jfloatArray out,
+        jint refineMode
+) {
+    TRACE_FUNCTION("detectSurfaceCurvature");
+    if (out == nullptr || env->GetArrayLength(out) < 15) {
+        LOGE("Surface result array must hold 15 floats");
+        return JNI_FALSE;
+    }
+
+    cv::Mat &img = *(cv::Mat *) matPtr;
+    if (img.empty()) {
+        LOGE("Input Mat is empty!");
+        return JNI_FALSE;
+    }
+
+    vector<Point2f> corners;
+    if (!detectRefinedCorners(img, cols, rows, false, refineMode, corners))
+        return JNI_FALSE;
+
+    TRACE_SCOPE("fit");
+    MemoryStageScope memStage(MEM_STAGE_FIT);
+    SurfaceFit fit;
+    if (!fitQuadricSurface(corners.data(), cols, rows, fit)) {
+        LOGE("Quadric surface fit failed.");
+        return JNI_FALSE;
+    }
+
+    float packed[15];
+    packed[0] = (float) fit.horizontalRadius;
+    packed[1] = (float) fit.verticalRadius;
+    packed[2] = (float) fit.rmsResidual;
+    for (int i = 0; i < 6; ++i) {
+        packed[3 + i] = (float) fit.x[i];
+        packed[9 + i] = (float) fit.y[i];
+    }
+    env->SetFloatArrayRegion(out, 0, 15, packed);
+
+    LOGI("Surface radii: horizontal %.2f px, vertical %.2f px (rms %.3f px)",
+         fit.horizontalRadius, fit.verticalRadius, fit.rmsResidual);
+    return JNI_TRUE;
+}
+
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_pixelRadiusToMeters(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jfloat radiusPx,
+        jfloat pixelPitchMM
+) {
+    TRACE_FUNCTION("pixelRadiusToMeters");
+    /**
+     * Converts a curvature radius from pixels to meters.
+     *
+     * @param radiusPx       Radius of curvature in pixels.
+     * @param pixelPitchMM   Physical pixel pitch in millimeters.
+     * @return               Radius of curvature in meters.
+     */
+    if (radiusPx <= 0.0f) return -1.0f;
+    float radiusMeters = (radiusPx * pixelPitchMM) / 1000.0f;
+    return radiusMeters;
+}
+
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfile(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jint width,
+        jfloat radiusPx
+) {
+    TRACE_FUNCTION("generateCurvatureProfile");
+    /**
+     * Generates curvature profile (height deviation along x-axis).
+     *
+     * @param width      Image width in pixels.
+     * @param radiusPx   Radius of curvature (pixels).
+     * @return           Java float[] of z(x) values.
+     */
+    jfloatArray jProfile = env->NewFloatArray(width);
+    if (jProfile == nullptr || width <= 0) return jProfile;
+
+    // Compute straight into the array instead of a temporary vector + copy.
+    auto *out = static_cast<float *>(env->GetPrimitiveArrayCritical(jProfile, nullptr));
+    if (out == nullptr) return jProfile;
+    computeCurvatureProfile(width, radiusPx, out);
+    env->ReleasePrimitiveArrayCritical(jProfile, out, 0);
+    return jProfile;
+}
+
+/**
+ * Writes the curvature profile into a caller-owned float[] starting at
+ * @p offset, through a pinned GetPrimitiveArrayCritical region (no
+ * allocation, no copy).
+ *
+ * @return false if the array is too small.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoArray(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jint width,
+        jfloat radiusPx,
+        jfloatArray out,
+        jint offset
+) {
+    TRACE_FUNCTION("generateCurvatureProfileIntoArray");
+    if (out == nullptr || width <= 0 || offset < 0 || env->GetArrayLength(out) - offset < width) {
+        LOGE("Profile array must hold %d floats from offset %d", width, offset);
+        return JNI_FALSE;
+    }
+
+    auto *pinned = static_cast<float *>(env->GetPrimitiveArrayCritical(out, nullptr));
+    if (pinned == nullptr) return JNI_FALSE;
+    computeCurvatureProfile(width, radiusPx, pinned + offset);
+    env->ReleasePrimitiveArrayCritical(out, pinned, 0);
+    return JNI_TRUE;
+}
+
+/**
+ * Writes the curvature profile into a direct buffer, from its base address.
+ * @p elementSize is 4 for a FloatBuffer and 1 for a ByteBuffer, because
+ * GetDirectBufferCapacity counts buffer elements.
+ */
+static jboolean profileIntoDirectBuffer(JNIEnv *env, jint width, jfloat radiusPx,
+                                        jobject buffer, int elementSize) {
+    auto *out = buffer ? static_cast<float *>(env->GetDirectBufferAddress(buffer)) : nullptr;
+    if (out == nullptr || width <= 0 ||
+        env->GetDirectBufferCapacity(buffer) * elementSize < (jlong) width * (jlong) sizeof(float)) {
+        LOGE("Profile buffer must be direct and hold %d floats", width);
+        return JNI_FALSE;
+    }
+    computeCurvatureProfile(width, radiusPx, out);
+    return JNI_TRUE;
+}
+
+/** Direct ByteBuffer (native order) variant of generateCurvatureProfileIntoArray. */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoByteBuffer(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jint width,
+        jfloat radiusPx,
+        jobject buffer
+) {
+    TRACE_FUNCTION("generateCurvatureProfileIntoByteBuffer");
+    return profileIntoDirectBuffer(env, width, radiusPx, buffer, 1);
+}
+
+/** Direct FloatBuffer variant of generateCurvatureProfileIntoArray. */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoFloatBuffer(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jint width,
+        jfloat radiusPx,
+        jobject buffer
+) {
+    TRACE_FUNCTION("generateCurvatureProfileIntoFloatBuffer");
+    return profileIntoDirectBuffer(env, width, radiusPx, buffer, (int) sizeof(float));
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureMapHandle(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jint width,
+        jint height,
+        jfloat radiusPx
+) {
+    TRACE_FUNCTION("generateCurvatureMapHandle");
     /**
-     * Generates curvature profile (height deviation along x-axis).
+     * Generates a 2D curvature height map (CV_32F Mat).
+     * Each pixel represents z(x) deviation based on curvature radius.
      *
-     * @param width      Image width in pixels.
-     * @param radiusPx   Radius of curvature (pixels).
-     * @return           Java float[] of z(x) values.
+     * @param width     Image width.
+     * @param height    Image height.
+     * @param radiusPx  Curvature radius in pixels.
+     * @return          Registry handle (HANDLE_MAT) of the map; resolve it with
+     *                  nativeMatAddr and free it with releaseNative.
+     */
+    // z depends only on x: compute and normalize one row, then broadcast it.
+    CurvatureProfile profile(width, height, radiusPx);
+    return registerHandle(new cv::Mat(profile.dense()), HANDLE_MAT);
+}
+
+/**
+ * Creates a broadcast curvature map (see CurvatureProfile): only the 1 x W
+ * normalized profile is computed; a dense H x W Mat is built on request.
+ *
+ * @return Native handle. Release with releaseCurvatureProfile.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_createCurvatureProfile(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jint width,
+        jint height,
+        jfloat radiusPx
+) {
+    TRACE_FUNCTION("createCurvatureProfile");
+    if (width <= 0 || height <= 0) {
+        LOGE("Invalid profile size: %dx%d", width, height);
+        return 0;
+    }
+    return registerHandle(new CurvatureProfile(width, height, radiusPx), HANDLE_CURVATURE_PROFILE);
+}
+
+/**
+ * Copies the W normalized profile values, i.e. any row of the broadcast map.
+ */
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_curvatureProfileRow(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("curvatureProfileRow");
+    auto profile = lookupHandle<CurvatureProfile>(handle, HANDLE_CURVATURE_PROFILE);
+    if (!profile) return nullptr;
+
+    jfloatArray jRow = env->NewFloatArray(profile->width());
+    env->SetFloatArrayRegion(jRow, 0, profile->width(), profile->row(0));
+    return jRow;
+}
+
+/**
+ * Materializes (once, in parallel) and returns the dense H x W CV_32F map.
+ * The Mat is owned by the profile and stays valid until releaseCurvatureProfile.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_curvatureProfileDense(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("curvatureProfileDense");
+    auto profile = lookupHandle<CurvatureProfile>(handle, HANDLE_CURVATURE_PROFILE);
+    if (!profile) return 0;
+    return reinterpret_cast<jlong>(&profile->dense());
+}
+
+/**
+ * Frees a profile created by createCurvatureProfile, including its dense map.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_releaseCurvatureProfile(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("releaseCurvatureProfile");
+    releaseTyped(handle, HANDLE_CURVATURE_PROFILE);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlat(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jlong matPtr,
+        jfloat radiusPx
+) {
+    TRACE_FUNCTION("warpCurvedToFlat");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    /**
+     * Warps a curved image into a flat projection using sinusoidal remap.
+     *
+     * @param matPtr    Pointer to input cv::Mat (curved image).
+     * @param radiusPx  Radius of curvature (pixels).
+     * @return          Pointer to new cv::Mat (flattened image).
      */
-    std::vector<float> profile(width);
-    float half = width / 2.0f;
-    for (int i = 0; i < width; ++i) {
-        float x = (i - half);
-        profile[i] = radiusPx - sqrtf(radiusPx * radiusPx - x * x);
+    cv::Mat &mat = *(cv::Mat *) matPtr;
+    if (mat.empty() || radiusPx <= 0.0f) return;
+
+    // 8U/16U/32F frames use the separable row resampler; other depths fall
+    // back to cached maps + remap.
+    if (isRowResampleSupported(mat.depth())) {
+        RowResampleTable table;
+        buildCylinderResampleTable(mat.cols, mat.channels(), radiusPx, cv::INTER_LINEAR, table);
+        resampleRowsInPlace(mat, table);
+        return;
+    }
+
+    cv::Mat map1, map2;
+    FlattenMapCache::instance().get({mat.cols, mat.rows, radiusPx, 0.0f,
+                                     cv::INTER_LINEAR, cv::BORDER_CONSTANT}, map1, map2);
+
+    TRACE_SCOPE("remap");
+    cv::remap(mat.clone(), mat, map1, map2, cv::INTER_LINEAR);
+}
+
+/**
+ * Warps a curved image to a flat projection, modifying the original Mat in-place.
+ *
+ * This function assumes the screen curvature follows a circular arc (1D curvature along width).
+ * It generates a mapping based on the provided radius, then remaps the input image so that
+ * curved pixels are repositioned as if the screen were flat.
+ *
+ * @param env      JNI environment.
+ * @param thiz     Java instance (unused).
+ * @param matAddr  Native address of cv::Mat to warp (modified in-place).
+ * @param radiusPx Radius of curvature in pixels. Larger → less curvature.
+ * @param interpolation cv::INTER_LINEAR or cv::INTER_CUBIC.
+ * @param bandParallel  Row-resampler path only (8U/16U/32F): split rows across threads (one scratch row each)
+ *                      instead of reusing a single scratch row on the calling thread.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlatInPlace(
+        JNIEnv *env,
+        jobject instance,
+        jlong matAddr,
+        jfloat radiusPx,
+        jint interpolation,
+        jboolean bandParallel
+) {
+    TRACE_FUNCTION("warpCurvedToFlatInPlace");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    // --- Validate inputs ---
+    cv::Mat &mat = *(cv::Mat *) matAddr;
+    if (mat.empty()) {
+        LOGE("Input Mat is empty!");
+        return;
+    }
+    if (radiusPx <= 0.0f) {
+        LOGE("Invalid radius: %.2f", radiusPx);
+        return;
+    }
+
+    const int width = mat.cols;
+    const int height = mat.rows;
+
+    LOGI("Warping image %dx%d with radius = %.2f px", width, height, radiusPx);
+
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+
+    if (isRowResampleSupported(mat.depth())) {
+        // --- 1️⃣ Per-column gather table: the warp only moves pixels along rows ---
+        RowResampleTable table;
+        buildCylinderResampleTable(width, mat.channels(), radiusPx, interpolation, table);
+
+        // --- 2️⃣ Resample rows in place: one scratch row per band, no full-frame clone ---
+        resampleRowsInPlace(mat, table, bandParallel);
+    } else {
+        // --- 1️⃣ Fetch remap matrices (built once per size/radius, fixed point) ---
+        cv::Mat map1, map2;
+        FlattenMapCache::instance().get({width, height, radiusPx, 0.0f,
+                                         interpolation, cv::BORDER_CONSTANT}, map1, map2);
+
+        // --- 2️⃣ Remap curved image to flat projection ---
+        cv::Mat srcClone = mat.clone();
+        TRACE_SCOPE("remap");
+        cv::remap(srcClone, mat, map1, map2, interpolation, BORDER_CONSTANT, Scalar(0, 0, 0));
+    }
+
+    LOGI("Warp completed successfully.");
+}
+
+/**
+ * Flattens a wall curved about both axes (dome/barrel) in place.
+ *
+ * @param env      JNI environment.
+ * @param thiz     Java instance (unused).
+ * @param matAddr  Native address of cv::Mat to warp (modified in-place).
+ * @param radiusH  Horizontal radius in pixels, <= 0 for no horizontal correction.
+ * @param radiusV  Vertical radius in pixels, <= 0 for no vertical correction.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_warpDomeToFlatInPlace(
+        JNIEnv *env,
+        jobject instance,
+        jlong matAddr,
+        jfloat radiusH,
+        jfloat radiusV
+) {
+    TRACE_FUNCTION("warpDomeToFlatInPlace");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    cv::Mat &mat = *(cv::Mat *) matAddr;
+    if (mat.empty()) {
+        LOGE("Input Mat is empty!");
+        return;
+    }
+
+    cv::Mat map1, map2;
+    FlattenMapCache::instance().get({mat.cols, mat.rows, std::max(radiusH, 0.0f), std::max(radiusV, 0.0f),
+                                     cv::INTER_LINEAR, cv::BORDER_CONSTANT}, map1, map2);
+
+    cv::Mat srcClone = mat.clone();
+    TRACE_SCOPE("remap");
+    cv::remap(srcClone, mat, map1, map2, cv::INTER_LINEAR, BORDER_CONSTANT, Scalar(0, 0, 0));
+}
+
+/**
+ * Pre-distorts flat content so it looks flat once shown on a cylindrical wall
+ * (the inverse of warpCurvedToFlatInPlace), modifying the Mat in place.
+ *
+ * Uses the same per-row gather table as the flatten warp, so nothing
+ * frame-sized is allocated. Columns that fall outside the arc are black.
+ *
+ * @param matAddr       Native address of a CV_8U, CV_16U or CV_32F cv::Mat.
+ * @param radiusPx      Radius of curvature in pixels.
+ * @param interpolation cv::INTER_LINEAR or cv::INTER_CUBIC.
+ * @param bandParallel  Split rows across threads (one scratch row each).
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_warpFlatToCurvedInPlace(
+        JNIEnv *env,
+        jobject instance,
+        jlong matAddr,
+        jfloat radiusPx,
+        jint interpolation,
+        jboolean bandParallel
+) {
+    TRACE_FUNCTION("warpFlatToCurvedInPlace");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    cv::Mat &mat = *(cv::Mat *) matAddr;
+    if (mat.empty() || !isRowResampleSupported(mat.depth())) {
+        LOGE("Pre-distortion needs a non-empty 8U, 16U or 32F Mat");
+        return;
+    }
+    if (radiusPx <= 0.0f) {
+        LOGE("Invalid radius: %.2f", radiusPx);
+        return;
+    }
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+
+    RowResampleTable table;
+    buildCylinderResampleTable(mat.cols, mat.channels(), radiusPx, interpolation, table, true);
+    resampleRowsInPlace(mat, table, bandParallel);
+}
+
+/**
+ * Undistorts and flattens a frame in one remap, modifying the Mat in place.
+ *
+ * Lens undistortion (initUndistortRectifyMap style, new camera matrix equal to
+ * the camera matrix) is composed into the dome/cylinder flatten map, and the
+ * composed map is cached per size, radii and intrinsics, so each frame pays a
+ * single resampling pass instead of undistort + flatten.
+ *
+ * @param matAddr       Native address of cv::Mat to warp (modified in-place).
+ * @param radiusH       Horizontal radius in pixels (<= 0: no horizontal flatten).
+ * @param radiusV       Vertical radius in pixels (<= 0: no vertical flatten).
+ * @param cameraMatrix  Row-major 3x3 camera matrix, or [fx, fy, cx, cy].
+ * @param distCoeffs    k1, k2, p1, p2[, k3]; missing trailing terms are 0.
+ * @param interpolation cv::INTER_LINEAR or cv::INTER_CUBIC.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_warpUndistortFlatInPlace(
+        JNIEnv *env,
+        jobject instance,
+        jlong matAddr,
+        jfloat radiusH,
+        jfloat radiusV,
+        jfloatArray cameraMatrix,
+        jfloatArray distCoeffs,
+        jint interpolation
+) {
+    TRACE_FUNCTION("warpUndistortFlatInPlace");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    cv::Mat &mat = *(cv::Mat *) matAddr;
+    if (mat.empty() || cameraMatrix == nullptr) {
+        LOGE("Input Mat is empty or camera matrix missing!");
+        return;
+    }
+
+    // --- 1️⃣ Read intrinsics ---
+    float k[9] = {0};
+    const jsize kLen = env->GetArrayLength(cameraMatrix);
+    if (kLen != 9 && kLen != 4) {
+        LOGE("Camera matrix must have 9 or 4 elements, got %d", (int) kLen);
+        return;
+    }
+    env->GetFloatArrayRegion(cameraMatrix, 0, kLen, k);
+
+    float d[5] = {0};
+    if (distCoeffs != nullptr) {
+        const jsize dLen = std::min<jsize>(env->GetArrayLength(distCoeffs), 5);
+        env->GetFloatArrayRegion(distCoeffs, 0, dLen, d);
+    }
+
+    LensModel lens{};
+    if (kLen == 9) {
+        lens.fx = k[0]; lens.fy = k[4]; lens.cx = k[2]; lens.cy = k[5];
+    } else {
+        lens.fx = k[0]; lens.fy = k[1]; lens.cx = k[2]; lens.cy = k[3];
+    }
+    lens.k1 = d[0]; lens.k2 = d[1]; lens.p1 = d[2]; lens.p2 = d[3]; lens.k3 = d[4];
+    if (lens.fx <= 0.0f || lens.fy <= 0.0f) {
+        LOGE("Invalid focal length: %.2f, %.2f", lens.fx, lens.fy);
+        return;
+    }
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+
+    // --- 2️⃣ Fetch the composed map (built once per size/radii/lens, fixed point) ---
+    cv::Mat map1, map2;
+    FlattenMapCache::instance().get({mat.cols, mat.rows, std::max(radiusH, 0.0f), std::max(radiusV, 0.0f),
+                                     interpolation, cv::BORDER_CONSTANT, lens}, map1, map2);
+
+    // --- 3️⃣ One remap: distorted camera frame -> undistorted, flattened output ---
+    cv::Mat srcClone = mat.clone();
+    TRACE_SCOPE("remap");
+    cv::remap(srcClone, mat, map1, map2, interpolation, BORDER_CONSTANT, Scalar(0, 0, 0));
+}
+
+/**
+ * Flattens only the visible part of a frame for zoomed previews.
+ *
+ * @param srcAddr   Native address of the full curved cv::Mat (not modified).
+ * @param dstAddr   Native address of the output cv::Mat, reallocated to the
+ *                  viewport size at display resolution (roiW·scale x roiH·scale).
+ * @param radiusH   Horizontal radius in pixels (<= 0: none).
+ * @param radiusV   Vertical radius in pixels (<= 0: none).
+ * @param roiX      Left edge of the viewport in flattened full-resolution pixels.
+ * @param roiY      Top edge of the viewport.
+ * @param roiW      Viewport width in flattened pixels.
+ * @param roiH      Viewport height in flattened pixels.
+ * @param scale     Display pixels per flattened pixel (the zoom factor).
+ * @param srcRoiOut Optional int[4] receiving the source region read: x, y, w, h.
+ * @return          false on invalid input or if the viewport misses the frame.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_warpFlatViewport(
+        JNIEnv *env,
+        jobject instance,
+        jlong srcAddr,
+        jlong dstAddr,
+        jfloat radiusH,
+        jfloat radiusV,
+        jfloat roiX,
+        jfloat roiY,
+        jfloat roiW,
+        jfloat roiH,
+        jfloat scale,
+        jint interpolation,
+        jintArray srcRoiOut
+) {
+    TRACE_FUNCTION("warpFlatViewport");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    const cv::Mat &src = *(cv::Mat *) srcAddr;
+    cv::Mat &dst = *(cv::Mat *) dstAddr;
+    if (src.empty() || roiW <= 0.0f || roiH <= 0.0f || scale <= 0.0f) {
+        LOGE("Invalid viewport: %.1fx%.1f at scale %.3f", roiW, roiH, scale);
+        return JNI_FALSE;
+    }
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+
+    const cv::Rect srcRoi = warpFlatViewport(src, dst, radiusH, radiusV,
+                                             cv::Rect2f(roiX, roiY, roiW, roiH), scale, interpolation);
+
+    if (srcRoiOut != nullptr && env->GetArrayLength(srcRoiOut) >= 4) {
+        const jint values[] = {srcRoi.x, srcRoi.y, srcRoi.width, srcRoi.height};
+        env->SetIntArrayRegion(srcRoiOut, 0, 4, values);
+    }
+    return srcRoi.empty() ? JNI_FALSE : JNI_TRUE;
+}
+
+/**
+ * Returns flatten map cache counters:
+ * [hits, misses, evictions, entries, bytes held, capacity in bytes].
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_getWarpCacheStats(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("getWarpCacheStats");
+    FlattenMapCacheStats st = FlattenMapCache::instance().stats();
+    const jlong values[] = {st.hits, st.misses, st.evictions, st.entries, st.bytes, st.capacityBytes};
+    jlongArray jStats = env->NewLongArray(6);
+    env->SetLongArrayRegion(jStats, 0, 6, values);
+    return jStats;
+}
+
+/**
+ * Sets the byte budget of the flatten map cache, evicting entries if needed.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_setWarpCacheCapacity(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong bytes
+) {
+    TRACE_FUNCTION("setWarpCacheCapacity");
+    FlattenMapCache::instance().setCapacity((size_t) std::max<jlong>(bytes, 0));
+}
+
+/**
+ * Drops every cached flatten map.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_clearWarpCache(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("clearWarpCache");
+    FlattenMapCache::instance().clear();
+}
+
+/**
+ * Creates a double-buffered RGBA pre-distortion stream (see PredistortStream).
+ *
+ * @return Native handle, 0 if the arguments are invalid. Release it with
+ *         releasePredistortStream.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_createPredistortStream(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jint width,
+        jint height,
+        jfloat radiusPx,
+        jint interpolation
+) {
+    TRACE_FUNCTION("createPredistortStream");
+    if (width <= 0 || height <= 0 || radiusPx <= 0.0f) {
+        LOGE("Invalid stream parameters: %dx%d, radius %.2f", width, height, radiusPx);
+        return 0;
     }
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+    return registerHandle(new PredistortStream(width, height, radiusPx, interpolation),
+                          HANDLE_PREDISTORT_STREAM);
+}
 
-    jfloatArray jProfile = env->NewFloatArray(width);
-    env->SetFloatArrayRegion(jProfile, 0, width, profile.data());
-    return jProfile;
+/**
+ * Wraps output buffer @p index (0 or 1) of a stream as a direct ByteBuffer of
+ * width * height * 4 bytes. The buffers live as long as the stream, so this
+ * is meant to be called once per index.
+ */
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_predistortStreamBuffer(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle,
+        jint index
+) {
+    TRACE_FUNCTION("predistortStreamBuffer");
+    auto stream = lookupHandle<PredistortStream>(handle, HANDLE_PREDISTORT_STREAM);
+    if (!stream || (index != 0 && index != 1)) return nullptr;
+    cv::Mat &buf = stream->buffer(index);
+    return env->NewDirectByteBuffer(buf.data, (jlong) (buf.total() * buf.elemSize()));
+}
+
+/**
+ * Pre-distorts one tightly packed RGBA frame held in a direct ByteBuffer.
+ *
+ * @return Index of the output buffer holding the result, -1 on invalid input.
+ */
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_predistortFrame(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle,
+        jobject frame
+) {
+    TRACE_FUNCTION("predistortFrame");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    auto stream = lookupHandle<PredistortStream>(handle, HANDLE_PREDISTORT_STREAM);
+    if (!stream || frame == nullptr) return -1;
+
+    void *pixels = env->GetDirectBufferAddress(frame);
+    const jlong needed = (jlong) stream->width() * stream->height() * 4;
+    if (pixels == nullptr || env->GetDirectBufferCapacity(frame) < needed) {
+        LOGE("Frame buffer must be direct and hold %lld bytes", (long long) needed);
+        return -1;
+    }
+
+    const cv::Mat rgba(stream->height(), stream->width(), CV_8UC4, pixels);
+    return stream->process(rgba);
+}
+
+/**
+ * Frees a stream created by createPredistortStream. Buffers obtained from
+ * predistortStreamBuffer must not be used afterwards.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_releasePredistortStream(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("releasePredistortStream");
+    releaseTyped(handle, HANDLE_PREDISTORT_STREAM);
 }
 
+/**
+ * Creates a corner-driven mesh flatten warp (see MeshWarp in mesh_warp.h).
+ *
+ * @param method   MESH_BILINEAR or MESH_THIN_PLATE.
+ * @param meshStep Coarse mesh spacing in pixels.
+ * @return         Native handle, 0 on invalid arguments. Release with releaseMeshWarp.
+ */
 extern "C"
 JNIEXPORT jlong JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureMap(
-        JNIEnv* env,
+Java_com_kuro_android_opencv_ChessBoardManager_createMeshWarp(
+        JNIEnv *env,
         jobject /*thiz*/,
         jint width,
         jint height,
-        jfloat radiusPx
+        jint cols,
+        jint rows,
+        jint method,
+        jint meshStep
 ) {
-    /**
-     * Generates a 2D curvature height map (CV_32F Mat).
-     * Each pixel represents z(x) deviation based on curvature radius.
-     *
-     * @param width     Image width.
-     * @param height    Image height.
-     * @param radiusPx  Curvature radius in pixels.
-     * @return          Native pointer (jlong) to cv::Mat curvature map.
-     */
-    cv::Mat map(height, width, CV_32F);
-    float half = width / 2.0f;
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            float dx = (x - half);
-            float z = radiusPx - sqrtf(radiusPx * radiusPx - dx * dx);
-            map.at<float>(y, x) = z;
-        }
+    TRACE_FUNCTION("createMeshWarp");
+    if (width <= 0 || height <= 0 || cols < 2 || rows < 2) {
+        LOGE("Invalid mesh warp parameters");
+        return 0;
     }
+    if (method != MESH_THIN_PLATE) method = MESH_BILINEAR;
+    return registerHandle(new MeshWarp(Size(width, height), cols, rows, method, meshStep),
+                          HANDLE_MESH_WARP);
+}
 
-    cv::normalize(map, map, 0, 1, cv::NORM_MINMAX);
-    cv::Mat *matPtr = new cv::Mat(map);
-    return reinterpret_cast<jlong>(matPtr);
+/**
+ * Detects the chessboard in @p matPtr and feeds its corners to the mesh warp.
+ * The maps are rebuilt only if a corner moved noticeably since the last build.
+ *
+ * @return 1 if the maps were rebuilt, 0 if the cached maps were kept,
+ *         -1 if the Mat is empty or not the warp's size, or the chessboard was
+ *         not found.
+ */
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_updateMeshWarp(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle,
+        jlong matPtr,
+        jint refineMode
+) {
+    TRACE_FUNCTION("updateMeshWarp");
+    auto warp = lookupHandle<MeshWarp>(handle, HANDLE_MESH_WARP);
+    if (!warp) return -1;
+
+    const cv::Mat &img = *(cv::Mat *) matPtr;
+    if (img.empty() || img.size() != warp->size()) {
+        LOGE("Mesh warp input must be a non-empty %dx%d Mat", warp->size().width, warp->size().height);
+        return -1;
+    }
+    vector<Point2f> corners;
+    if (!detectRefinedCorners(img, warp->cols(), warp->rows(), false, refineMode, corners))
+        return -1;
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    return warp->update(corners) ? 1 : 0;
 }
 
+/**
+ * Flattens @p matPtr in place with the cached mesh maps.
+ *
+ * @return false if the warp has no maps yet (no successful updateMeshWarp).
+ */
 extern "C"
-JNIEXPORT void JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlat(
-        JNIEnv* env,
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_applyMeshWarp(
+        JNIEnv *env,
         jobject /*thiz*/,
+        jlong handle,
         jlong matPtr,
-        jfloat radiusPx
+        jint interpolation
 ) {
-    /**
-     * Warps a curved image into a flat projection using sinusoidal remap.
-     *
-     * @param matPtr    Pointer to input cv::Mat (curved image).
-     * @param radiusPx  Radius of curvature (pixels).
-     * @return          Pointer to new cv::Mat (flattened image).
-     */
+    TRACE_FUNCTION("applyMeshWarp");
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    auto warp = lookupHandle<MeshWarp>(handle, HANDLE_MESH_WARP);
     cv::Mat &mat = *(cv::Mat *) matPtr;
-    int width = mat.cols;
-    int height = mat.rows;
-    float half = width / 2.0f;
-
-    cv::Mat mapX(height, width, CV_32F);
-    cv::Mat mapY(height, width, CV_32F);
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            float theta = (x - half) / radiusPx;
-            mapX.at<float>(y, x) = radiusPx * sinf(theta) + half;
-            mapY.at<float>(y, x) = y;
-        }
-    }
+    if (!warp || mat.empty() || mat.size() != warp->size()) return JNI_FALSE;
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+    return warp->apply(mat, interpolation) ? JNI_TRUE : JNI_FALSE;
+}
 
-    cv::remap(mat.clone(), mat, mapX, mapY, cv::INTER_LINEAR);
+/**
+ * Frees a mesh warp created by createMeshWarp.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_releaseMeshWarp(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("releaseMeshWarp");
+    releaseTyped(handle, HANDLE_MESH_WARP);
 }
 
 /**
- * Warps a curved image to a flat projection, modifying the original Mat in-place.
- *
- * This function assumes the screen curvature follows a circular arc (1D curvature along width).
- * It generates a mapping based on the provided radius, then remaps the input image so that
- * curved pixels are repositioned as if the screen were flat.
+ * Creates a CalibrationSession for a cols x rows inner-corner grid.
  *
- * @param env      JNI environment.
- * @param thiz     Java instance (unused).
- * @param matAddr  Native address of cv::Mat to warp (modified in-place).
- * @param radiusPx Radius of curvature in pixels. Larger → less curvature.
+ * @return Registry handle, 0 if the grid is invalid.
  */
 extern "C"
-JNIEXPORT void JNICALL
-Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlatInPlace(
+JNIEXPORT jlong JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_createCalibrationSession(
         JNIEnv *env,
-        jobject instance,
-        jlong matAddr,
-        jfloat radiusPx
+        jobject /*thiz*/,
+        jint cols,
+        jint rows
 ) {
-    // --- Validate inputs ---
-    cv::Mat &mat = *(cv::Mat *) matAddr;
-    if (mat.empty()) {
-        LOGE("Input Mat is empty!");
-        return;
+    TRACE_FUNCTION("createCalibrationSession");
+    if (cols < 3 || rows < 3) {
+        LOGE("Invalid session grid %dx%d", cols, rows);
+        return 0;
     }
-    if (radiusPx <= 0.0f) {
-        LOGE("Invalid radius: %.2f", radiusPx);
-        return;
+    return registerHandle(new CalibrationSession(cols, rows), HANDLE_CALIBRATION_SESSION);
+}
+
+/**
+ * Session counterpart of detectCurvatureIntoArray: gray image, corners, fits
+ * and the packed result all live in session-owned buffers.
+ *
+ * @param out    Receives the packed result from @p offset, or null to skip it.
+ * @return       Mean curvature radius in pixels, -1.0f if failed.
+ */
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionDetect(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle,
+        jlong matPtr,
+        jfloatArray out,
+        jint offset,
+        jint refineMode,
+        jint fitMode
+) {
+    TRACE_FUNCTION("calibrationSessionDetect");
+    auto session = lookupHandle<CalibrationSession>(handle, HANDLE_CALIBRATION_SESSION);
+    const cv::Mat &img = *(cv::Mat *) matPtr;
+    if (!session || img.empty()) return -1.0f;
+
+    const int count = curvatureResultFloats(session->cols(), session->rows());
+    if (out != nullptr && (offset < 0 || env->GetArrayLength(out) - offset < count)) {
+        LOGE("Result array too small: need %d floats at offset %d", count, offset);
+        return -1.0f;
     }
 
-    const int width = mat.cols;
-    const int height = mat.rows;
-    const float cx = width / 2.0f;  // optical center (horizontal middle)
+    const float *packed = nullptr;
+    const float meanRadius = session->detect(img, refineMode, fitMode, &packed);
+    if (out != nullptr) env->SetFloatArrayRegion(out, offset, count, packed);
+    return meanRadius;
+}
 
-    LOGI("Warping image %dx%d with radius = %.2f px", width, height, radiusPx);
+/**
+ * Flattens (or, with @p inverse, pre-distorts) a Mat in place using the
+ * session's cached gather table.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionWarp(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle,
+        jlong matPtr,
+        jfloat radiusPx,
+        jint interpolation,
+        jboolean inverse,
+        jboolean bandParallel
+) {
+    TRACE_FUNCTION("calibrationSessionWarp");
+    auto session = lookupHandle<CalibrationSession>(handle, HANDLE_CALIBRATION_SESSION);
+    if (!session) return JNI_FALSE;
+    cv::Mat &mat = *(cv::Mat *) matPtr;
+    return session->warpInPlace(mat, radiusPx, interpolation, inverse, bandParallel);
+}
 
-    // --- 1️⃣ Generate remap matrices (mapX, mapY) ---
-    cv::Mat mapX(height, width, CV_32F);
-    cv::Mat mapY(height, width, CV_32F);
+/**
+ * generateChessBoardGroupWithBlackPadInto through the session's pattern
+ * cache: an unchanged layout is copied from the cached canvas instead of
+ * being drawn again.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionPatternInto(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle,
+        jobject bitmap,
+        jint totalWidth,
+        jint totalHeight,
+        jint groupXOffset,
+        jint groupYOffset,
+        jint groupWidth,
+        jint groupHeight,
+        jint activeXOffset,
+        jint activeYOffset,
+        jint activeWidth,
+        jint activeHeight,
+        jint cols,
+        jint rows
+) {
+    TRACE_FUNCTION("calibrationSessionPatternInto");
+    auto session = lookupHandle<CalibrationSession>(handle, HANDLE_CALIBRATION_SESSION);
+    if (!session || groupWidth <= 0 || groupHeight <= 0) return JNI_FALSE;
+
+    const PatternKey key = {totalWidth, totalHeight, groupXOffset, groupYOffset, groupWidth, groupHeight,
+                            activeXOffset, activeYOffset, activeWidth, activeHeight, cols, rows};
+    return renderIntoBitmap(env, bitmap, groupWidth, groupHeight, [&](Mat &rgba) {
+        const Mat &cached = session->pattern(key, [&](Mat &canvas) {
+            renderChessBoardGroupWithBlackPad(canvas, totalWidth, totalHeight, groupXOffset, groupYOffset,
+                                              activeXOffset, activeYOffset, activeWidth, activeHeight,
+                                              cols, rows);
+        });
+        cached.copyTo(rgba); // same size and type: written into the bitmap pixels
+    });
+}
 
-    // Optional exaggeration factor for debugging visualization
-    const float visualScale = 1.0f; // < 1.0 to exaggerate curvature visually (e.g. 0.1f)
+/**
+ * @return [frames, allocations, mapBuilds, patternBuilds, arenaBytes, bytes],
+ *         or null for a released session.
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionStats(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("calibrationSessionStats");
+    auto session = lookupHandle<CalibrationSession>(handle, HANDLE_CALIBRATION_SESSION);
+    if (!session) return nullptr;
+    const CalibrationSessionStats s = session->stats();
+    const jlong values[] = {s.frames, s.allocations, s.mapBuilds, s.patternBuilds, s.arenaBytes, s.bytes};
+    jlongArray result = env->NewLongArray(6);
+    env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
 
-    for (int y = 0; y < height; ++y) {
-        float *ptrX = mapX.ptr<float>(y);
-        float *ptrY = mapY.ptr<float>(y);
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_releaseCalibrationSession(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("releaseCalibrationSession");
+    releaseTyped(handle, HANDLE_CALIBRATION_SESSION);
+}
 
-        for (int x = 0; x < width; ++x) {
-            // Convert pixel to angular displacement θ along curved surface
-            float theta = (x - cx) / (radiusPx * visualScale);
+/**
+ * Resolves a HANDLE_MAT registry handle (e.g. from generateCurvatureMapHandle)
+ * to the cv::Mat address OpenCV's Java API expects. The address is only valid
+ * while the handle is alive.
+ *
+ * @return Mat address, 0 if the handle is stale or not a Mat.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_nativeMatAddr(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("nativeMatAddr");
+    auto mat = lookupHandle<cv::Mat>(handle, HANDLE_MAT);
+    return reinterpret_cast<jlong>(mat.get());
+}
 
-            // Compute new flat-space X coordinate using cylindrical projection
-            float flatX = radiusPx * sinf(theta) + cx;
-            ptrX[x] = flatX;
-            ptrY[x] = (float) y; // No vertical distortion assumed
-        }
+/**
+ * Releases any registry handle. Stale or already released handles are
+ * ignored, so this is safe to call from both close() and a Cleaner action.
+ *
+ * @return true if this call freed the object.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_releaseNative(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong handle
+) {
+    TRACE_FUNCTION("releaseNative");
+    return HandleRegistry::instance().release(handle) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Native memory held through registry handles:
+ * [totalBytes, totalCount, then bytes and count for each HandleType].
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_getNativeHandleStats(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("getNativeHandleStats");
+    HandleTypeStats perType[HANDLE_TYPE_COUNT];
+    HandleRegistry::instance().stats(perType);
+
+    jlong values[2 + 2 * HANDLE_TYPE_COUNT] = {0};
+    for (int t = 0; t < HANDLE_TYPE_COUNT; ++t) {
+        values[0] += perType[t].bytes;
+        values[1] += perType[t].count;
+        values[2 + 2 * t] = perType[t].bytes;
+        values[3 + 2 * t] = perType[t].count;
     }
 
-    // --- 2️⃣ Remap curved image to flat projection ---
-    cv::Mat srcClone = mat.clone();
-    cv::remap(srcClone, mat, mapX, mapY, cv::INTER_LINEAR, BORDER_CONSTANT, Scalar(0, 0, 0));
+    const jsize n = 2 + 2 * HANDLE_TYPE_COUNT;
+    jlongArray jStats = env->NewLongArray(n);
+    env->SetLongArrayRegion(jStats, 0, n, values);
+    return jStats;
+}
 
-    LOGI("Warp completed successfully.");
+/**
+ * Total bytes currently held by objects behind registry handles.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_getNativeBytesHeld(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("getNativeBytesHeld");
+    HandleTypeStats perType[HANDLE_TYPE_COUNT];
+    HandleRegistry::instance().stats(perType);
+
+    jlong total = 0;
+    for (const HandleTypeStats &st : perType) total += st.bytes;
+    return total;
+}
+
+/**
+ * Mat memory allocated inside pipeline calls, on the calling thread and in
+ * our own parallel bodies. Allocations on OpenCV's internal worker threads
+ * are not included, so mallocs flattening out does not prove that a run is
+ * allocation free.
+ *
+ * @return [pooledBytes, pooledBuffers, poolCapacityBytes], then for each
+ *         MemoryStage [allocations, mallocs, currentBytes, peakBytes, totalBytes].
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_getMemoryStats(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("getMemoryStats");
+    PooledMatAllocator &allocator = PooledMatAllocator::instance();
+    MemoryStageStats perStage[MEM_STAGE_COUNT];
+    allocator.stageStats(perStage);
+
+    jlong values[3 + 5 * MEM_STAGE_COUNT];
+    values[0] = (jlong) allocator.pooledBytes();
+    values[1] = (jlong) allocator.pooledBuffers();
+    values[2] = (jlong) allocator.capacity();
+    for (int s = 0; s < MEM_STAGE_COUNT; ++s) {
+        jlong *v = values + 3 + 5 * s;
+        v[0] = perStage[s].allocations;
+        v[1] = perStage[s].mallocs;
+        v[2] = perStage[s].currentBytes;
+        v[3] = perStage[s].peakBytes;
+        v[4] = perStage[s].totalBytes;
+    }
+
+    const jsize n = 3 + 5 * MEM_STAGE_COUNT;
+    jlongArray jStats = env->NewLongArray(n);
+    env->SetLongArrayRegion(jStats, 0, n, values);
+    return jStats;
+}
+
+/** Resets every stage's high-water mark to its current usage. */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_resetMemoryPeaks(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    TRACE_FUNCTION("resetMemoryPeaks");
+    PooledMatAllocator::instance().resetPeaks();
+}
+
+/** Sets the byte budget for idle pooled Mat buffers, freeing any excess. */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_setMatPoolCapacity(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jlong bytes
+) {
+    TRACE_FUNCTION("setMatPoolCapacity");
+    PooledMatAllocator::instance().setCapacity(bytes > 0 ? (size_t) bytes : 0);
+}
+
+/**
+ * Starts recording native spans (JNI entry points and pipeline stages);
+ * spans from an earlier recording are discarded.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_startNativeTrace(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    startTrace();
+}
+
+/**
+ * Stops recording native spans; the recorded spans stay available to writeNativeTrace.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_stopNativeTrace(
+        JNIEnv *env,
+        jobject /*thiz*/
+) {
+    stopTrace();
+}
+
+/**
+ * Writes the spans recorded since startNativeTrace as Chrome trace JSON,
+ * viewable in chrome://tracing or the Perfetto UI.
+ *
+ * @param path Output file, e.g. under the app's files directory.
+ * @return Number of spans written, -1 if the file could not be opened.
+ */
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_kuro_android_opencv_ChessBoardManager_writeNativeTrace(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jstring path
+) {
+    if (path == nullptr) return -1;
+    const char *cPath = env->GetStringUTFChars(path, nullptr);
+    if (cPath == nullptr) return -1;
+    const int written = writeChromeTrace(cPath);
+    env->ReleaseStringUTFChars(path, cPath);
+    if (written < 0) LOGE("Could not write native trace");
+    else LOGI("Wrote %d native trace spans", written);
+    return written;
 }
@@ -0,0 +1,320 @@
+#include "corner_refine.h"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "mat_allocator.h"
+#include "trace_spans.h"
+
+using namespace cv;
+using namespace std;
+
+// Below this many corners per worker the thread dispatch costs more than it saves.
+static const int MIN_CORNERS_PER_CHUNK = 16;
+
+void refineCornersParallel(const Mat &gray,
+                           vector<Point2f> &corners,
+                           Size winSize,
+                           Size zeroZone,
+                           TermCriteria criteria) {
+    const int n = (int) corners.size();
+    if (n == 0) return;
+
+    const int maxChunks = (n + MIN_CORNERS_PER_CHUNK - 1) / MIN_CORNERS_PER_CHUNK;
+    const int chunks = std::max(1, std::min(getNumThreads(), maxChunks));
+    if (chunks == 1) {
+        cornerSubPix(gray, corners, winSize, zeroZone, criteria);
+        return;
+    }
+
+    const int chunkSize = (n + chunks - 1) / chunks;
+    const int memStageId = MemoryStageScope::current();
+    parallel_for_(Range(0, chunks), [&](const Range &range) {
+        TRACE_SCOPE("cornerSubPixChunk");
+        MemoryStageScope memStage(memStageId);
+        for (int c = range.start; c < range.end; ++c) {
+            const int begin = c * chunkSize;
+            const int end = std::min(n, begin + chunkSize);
+            if (begin >= end) continue;
+
+            // Header over the chunk's slice: cornerSubPix refines it in place, no copy.
+            Mat chunk(end - begin, 1, CV_32FC2, &corners[begin]);
+            cornerSubPix(gray, chunk, winSize, zeroZone, criteria);
+        }
+    });
+}
+
+void refineCornersCoarseToFine(const Mat &gray,
+                               vector<Point2f> &corners,
+                               Size winSize,
+                               Size zeroZone,
+                               TermCriteria criteria,
+                               RefineScratch *scratch) {
+    const int n = (int) corners.size();
+    if (n == 0) return;
+
+    RefineScratch local;
+    RefineScratch &s = scratch ? *scratch : local;
+    Mat &half = s.half;
+    vector<Point2f> &coarse = s.coarse, &settled = s.settled, &active = s.active;
+    vector<int> &settledIdx = s.settledIdx, &activeIdx = s.activeIdx;
+
+    // --- 1️⃣ Coarse pass on the first pyramid level
+    pyrDown(gray, half);
+
+    coarse.resize(n);
+    for (int i = 0; i < n; ++i) coarse[i] = corners[i] * 0.5f;
+
+    Size coarseWin(std::max(2, winSize.width / 2), std::max(2, winSize.height / 2));
+    Size coarseZero = zeroZone.width < 0 ? zeroZone
+                                         : Size(zeroZone.width / 2, zeroZone.height / 2);
+    refineCornersParallel(half, coarse, coarseWin, coarseZero, criteria);
+
+    // --- 2️⃣ Split corners by whether the coarse level already converged
+    const double eps = (criteria.type & TermCriteria::EPS) ? criteria.epsilon : 0.0;
+    settledIdx.clear();
+    activeIdx.clear();
+    settled.clear();
+    active.clear();
+    settledIdx.reserve(n);
+    activeIdx.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+        Point2f up = coarse[i] * 2.0f;
+        Point2f d = up - corners[i];
+        if (d.x * d.x + d.y * d.y < eps * eps) {
+            settledIdx.push_back(i);
+            settled.push_back(corners[i]);
+        } else {
+            activeIdx.push_back(i);
+            active.push_back(up);
+        }
+    }
+
+    // --- 3️⃣ Fine pass: one iteration for settled corners, full criteria otherwise
+    if (!settled.empty()) {
+        TermCriteria once(TermCriteria::COUNT + TermCriteria::EPS, 1, criteria.epsilon);
+        refineCornersParallel(gray, settled, winSize, zeroZone, once);
+        for (size_t k = 0; k < settled.size(); ++k) corners[settledIdx[k]] = settled[k];
+    }
+    if (!active.empty()) {
+        refineCornersParallel(gray, active, winSize, zeroZone, criteria);
+        for (size_t k = 0; k < active.size(); ++k) corners[activeIdx[k]] = active[k];
+    }
+}
+
+/**
+ * Least-squares projection P = (AᵀA)⁻¹Aᵀ for the quadratic basis
+ * [u², uv, v², u, v, 1] sampled on the (2r+1)² grid, stored as six float rows
+ * zero-padded to a multiple of four so the dot products vectorize cleanly.
+ */
+static Mat buildSaddleProjection(int r, int paddedLen) {
+    const int side = 2 * r + 1;
+    const int n = side * side;
+    Mat A(n, 6, CV_64F);
+    for (int v = -r, i = 0; v <= r; ++v) {
+        for (int u = -r; u <= r; ++u, ++i) {
+            double *row = A.ptr<double>(i);
+            row[0] = u * u;
+            row[1] = u * v;
+            row[2] = v * v;
+            row[3] = u;
+            row[4] = v;
+            row[5] = 1.0;
+        }
+    }
+
+    Mat pinv;
+    invert(A, pinv, DECOMP_SVD);
+
+    Mat P = Mat::zeros(6, paddedLen, CV_32F);
+    pinv.convertTo(P(Rect(0, 0, n, 6)), CV_32F);
+    return P;
+}
+
+static inline float dotPadded(const float *a, const float *b, int len) {
+#if CV_SIMD128
+    v_float32x4 acc = v_setzero_f32();
+    for (int i = 0; i < len; i += 4)
+        acc = v_fma(v_load(a + i), v_load(b + i), acc);
+    return v_reduce_sum(acc);
+#else
+    float acc = 0.f;
+    for (int i = 0; i < len; ++i) acc += a[i] * b[i];
+    return acc;
+#endif
+}
+
+void refineCornersSaddle(const Mat &gray,
+                         vector<Point2f> &corners,
+                         int halfWin,
+                         int passes) {
+    CV_Assert(gray.channels() == 1);
+    const int n = (int) corners.size();
+    if (n == 0 || halfWin < 1) return;
+
+    const int r = halfWin;
+    const int side = 2 * r + 1;
+    const int paddedLen = (side * side + 3) & ~3;
+    const Mat P = buildSaddleProjection(r, paddedLen);
+
+    // Smoothing scale follows the window; one extra pixel of margin keeps the
+    // bilinear resampling inside the blurred patch while re-centring.
+    const double sigma = std::max(1.0, r / 2.5);
+    const int margin = (int) std::ceil(3.0 * sigma) + 1;
+    const int reach = r + margin;
+    const int blurSide = 2 * reach + 1;
+    const int ksize = 2 * (int) std::ceil(3.0 * sigma) + 1;
+
+    const int memStageId = MemoryStageScope::current();
+    parallel_for_(Range(0, n), [&](const Range &range) {
+        TRACE_SCOPE("saddleChunk");
+        MemoryStageScope memStage(memStageId);
+        Mat blurred(blurSide, blurSide, CV_32F);
+        Mat roiF(blurSide, blurSide, CV_32F);
+        AutoBuffer<float> patchBuf(paddedLen);
+        float *patch = patchBuf.data();
+        std::fill(patch, patch + paddedLen, 0.f);
+
+        for (int k = range.start; k < range.end; ++k) {
+            float x = corners[k].x;
+            float y = corners[k].y;
+            const int cx = cvRound(x);
+            const int cy = cvRound(y);
+
+            Rect roi(cx - reach, cy - reach, blurSide, blurSide);
+            if (roi.x < 0 || roi.y < 0 ||
+                roi.x + roi.width > gray.cols || roi.y + roi.height > gray.rows)
+                continue;
+
+            gray(roi).convertTo(roiF, CV_32F);
+            GaussianBlur(roiF, blurred, Size(ksize, ksize), sigma, sigma, BORDER_REPLICATE);
+
+            for (int pass = 0; pass < passes; ++pass) {
+                // --- Resample the patch around the current estimate
+                const float px = x - roi.x;
+                const float py = y - roi.y;
+                if (std::fabs(px - reach) > margin - 2 || std::fabs(py - reach) > margin - 2)
+                    break;
+                const int ix = cvFloor(px);
+                const int iy = cvFloor(py);
+                const float fx = px - ix;
+                const float fy = py - iy;
+                const float w00 = (1.f - fx) * (1.f - fy), w01 = fx * (1.f - fy);
+                const float w10 = (1.f - fx) * fy,         w11 = fx * fy;
+
+                for (int v = -r, i = 0; v <= r; ++v) {
+                    const float *s0 = blurred.ptr<float>(iy + v) + ix;
+                    const float *s1 = blurred.ptr<float>(iy + v + 1) + ix;
+                    for (int u = -r; u <= r; ++u, ++i)
+                        patch[i] = w00 * s0[u] + w01 * s0[u + 1] + w10 * s1[u] + w11 * s1[u + 1];
+                }
+
+                // --- Closed-form fit and saddle point of the quadric
+                const float a = dotPadded(P.ptr<float>(0), patch, paddedLen);
+                const float b = dotPadded(P.ptr<float>(1), patch, paddedLen);
+                const float c = dotPadded(P.ptr<float>(2), patch, paddedLen);
+                const float d = dotPadded(P.ptr<float>(3), patch, paddedLen);
+                const float e = dotPadded(P.ptr<float>(4), patch, paddedLen);
+
+                const float det = 4.f * a * c - b * b;
+                if (det >= 0.f) break; // extremum, not a saddle
+
+                const float dx = (b * e - 2.f * c * d) / det;
+                const float dy = (b * d - 2.f * a * e) / det;
+                if (std::fabs(dx) > 1.f || std::fabs(dy) > 1.f) break;
+
+                x += dx;
+                y += dy;
+            }
+
+            corners[k] = Point2f(x, y);
+        }
+    });
+}
+
+static float rmsError(const vector<Point2f> &a, const vector<Point2f> &b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        Point2f d = a[i] - b[i];
+        sum += d.x * d.x + d.y * d.y;
+    }
+    return a.empty() ? 0.f : (float) std::sqrt(sum / a.size());
+}
+
+RefineBenchmark benchmarkRefineEngines(int width, int height, int cols, int rows,
+                                       float noiseSigma, int iterations, uint64_t seed) {
+    CV_Assert(width > 0 && height > 0 && cols > 1 && rows > 1);
+    iterations = std::max(1, iterations);
+    RNG rng(seed);
+
+    // --- 1️⃣ Render at 8x and area-downsample, so edges land on exact 1/8 px positions
+    const int K = 8;
+    const double square = std::min(width / (cols + 3.0), height / (rows + 3.0));
+    const double ox = square + rng.uniform(0.0, 1.0);
+    const double oy = square + rng.uniform(0.0, 1.0);
+
+    vector<int> edgeX(cols + 2), edgeY(rows + 2);
+    for (int j = 0; j < cols + 2; ++j) edgeX[j] = cvRound((ox + j * square + 0.5) * K);
+    for (int i = 0; i < rows + 2; ++i) edgeY[i] = cvRound((oy + i * square + 0.5) * K);
+
+    Mat hi(height * K, width * K, CV_8UC1, Scalar(255));
+    for (int i = 0; i < rows + 1; ++i) {
+        for (int j = 0; j < cols + 1; ++j) {
+            if ((i + j) % 2 == 0) {
+                hi(Rect(edgeX[j], edgeY[i],
+                        edgeX[j + 1] - edgeX[j], edgeY[i + 1] - edgeY[i])).setTo(Scalar(0));
+            }
+        }
+    }
+
+    Mat gray;
+    resize(hi, gray, Size(width, height), 0, 0, INTER_AREA);
+    hi.release();
+    GaussianBlur(gray, gray, Size(0, 0), 0.7);
+    if (noiseSigma > 0.f) {
+        Mat noise(gray.size(), CV_16S);
+        rng.fill(noise, RNG::NORMAL, 0, noiseSigma);
+        add(gray, noise, gray, noArray(), CV_8U);
+    }
+
+    // --- 2️⃣ Ground truth in pixel-centre coordinates and perturbed starting points
+    vector<Point2f> truth, initial;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            Point2f t(edgeX[c + 1] / (float) K - 0.5f, edgeY[r + 1] / (float) K - 0.5f);
+            truth.push_back(t);
+            initial.push_back(t + Point2f(rng.uniform(-1.f, 1.f), rng.uniform(-1.f, 1.f)));
+        }
+    }
+
+    // --- 3️⃣ Time both engines on identical inputs
+    RefineBenchmark result{};
+    result.initialRms = rmsError(initial, truth);
+    TermCriteria criteria(TermCriteria::EPS + TermCriteria::MAX_ITER, 30, 0.1);
+
+    vector<Point2f> refined;
+    int64 ticks = 0;
+    for (int it = 0; it < iterations; ++it) {
+        refined = initial;
+        int64 t0 = getTickCount();
+        refineCornersParallel(gray, refined, Size(11, 11), Size(-1, -1), criteria);
+        ticks += getTickCount() - t0;
+    }
+    result.subPixRms = rmsError(refined, truth);
+    result.subPixMs = (float) (ticks * 1000.0 / getTickFrequency() / iterations);
+
+    ticks = 0;
+    for (int it = 0; it < iterations; ++it) {
+        refined = initial;
+        int64 t0 = getTickCount();
+        refineCornersSaddle(gray, refined);
+        ticks += getTickCount() - t0;
+    }
+    result.saddleRms = rmsError(refined, truth);
+    result.saddleMs = (float) (ticks * 1000.0 / getTickFrequency() / iterations);
+
+    return result;
+}
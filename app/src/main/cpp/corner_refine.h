@@ -0,0 +1,111 @@
+#ifndef CORNER_REFINE_H
+#define CORNER_REFINE_H
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * Sub-pixel corner refinement modes selectable from detectCurvatureFromMat.
+ * Values are mirrored by the REFINE_* constants in ChessBoardManager.kt.
+ */
+enum RefineMode {
+    REFINE_SUBPIX = 0,                // cornerSubPix, split across parallel_for_ workers
+    REFINE_SUBPIX_COARSE_TO_FINE = 1, // half-resolution pass first, converged corners skip fine iterations
+    REFINE_SADDLE = 2                 // closed-form quadratic saddle fit on a smoothed patch
+};
+
+/**
+ * Refines corners with cornerSubPix, splitting them into chunks processed by
+ * parallel_for_ workers.
+ *
+ * cornerSubPix treats every corner independently, so the result is identical to
+ * a single serial call with the same window and termination criteria.
+ *
+ * @param gray     8-bit or float single-channel image.
+ * @param corners  Initial corner positions, refined in place.
+ * @param winSize  Half of the side length of the search window.
+ * @param zeroZone Half of the dead region in the middle of the window, (-1,-1) for none.
+ * @param criteria Termination criteria applied to every corner.
+ */
+void refineCornersParallel(const cv::Mat &gray,
+                           std::vector<cv::Point2f> &corners,
+                           cv::Size winSize,
+                           cv::Size zeroZone,
+                           cv::TermCriteria criteria);
+
+/**
+ * Working buffers of refineCornersCoarseToFine. Callers that refine every
+ * frame keep one so the pyramid level and index lists are reused.
+ */
+struct RefineScratch {
+    cv::Mat half;
+    std::vector<cv::Point2f> coarse, settled, active;
+    std::vector<int> settledIdx, activeIdx;
+};
+
+/**
+ * Coarse-to-fine variant of refineCornersParallel.
+ *
+ * Corners are first refined on a half-resolution pyramid level. Corners that
+ * barely move there (shift below criteria.epsilon at full resolution) are
+ * treated as converged and get a single fine iteration; the rest run the full
+ * criteria starting from the coarse estimate.
+ *
+ * @param scratch Optional reusable buffers; temporaries are allocated if null.
+ */
+void refineCornersCoarseToFine(const cv::Mat &gray,
+                               std::vector<cv::Point2f> &corners,
+                               cv::Size winSize,
+                               cv::Size zeroZone,
+                               cv::TermCriteria criteria,
+                               RefineScratch *scratch = nullptr);
+
+/**
+ * Refines chessboard X-corners by fitting a quadratic surface
+ * f(u,v) = a·u² + b·uv + c·v² + d·u + e·v + f to a Gaussian-smoothed patch
+ * and moving each corner to the saddle point of the fit.
+ *
+ * The least-squares projection for the fixed sampling grid is computed once per
+ * call, so each fit is six dot products. A fixed number of re-centring passes
+ * resamples the patch bilinearly around the current estimate; there is no
+ * iterative gradient loop. Corners whose fit is not a saddle, or whose patch
+ * leaves the image, keep their input position.
+ *
+ * @param gray    Single-channel image of any depth.
+ * @param corners Initial corner positions, refined in place.
+ * @param halfWin Half side of the fitted patch, (2·halfWin+1)² samples.
+ * @param passes  Number of re-centring passes.
+ */
+void refineCornersSaddle(const cv::Mat &gray,
+                         std::vector<cv::Point2f> &corners,
+                         int halfWin = 5,
+                         int passes = 3);
+
+/**
+ * Accuracy and speed of the refinement engines on one synthetic board.
+ * Errors are RMS distances to ground truth in pixels, times are milliseconds.
+ */
+struct RefineBenchmark {
+    float initialRms;
+    float subPixRms;
+    float subPixMs;
+    float saddleRms;
+    float saddleMs;
+};
+
+/**
+ * Renders an anti-aliased chessboard with known sub-pixel inner corners,
+ * perturbs the corners and times cornerSubPix against refineCornersSaddle.
+ *
+ * @param width      Synthetic image width.
+ * @param height     Synthetic image height.
+ * @param cols       Inner corners horizontally.
+ * @param rows       Inner corners vertically.
+ * @param noiseSigma Standard deviation of additive Gaussian noise (gray levels).
+ * @param iterations Number of timed runs averaged per engine.
+ * @param seed       RNG seed, so runs are reproducible.
+ */
+RefineBenchmark benchmarkRefineEngines(int width, int height, int cols, int rows,
+                                       float noiseSigma, int iterations, uint64_t seed);
+
+#endif // CORNER_REFINE_H
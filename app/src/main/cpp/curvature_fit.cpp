@@ -0,0 +1,575 @@
+#include "curvature_fit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace cv;
+
+namespace {
+
+/** Running sums for the normal equations of v = α·u² + β·u + γ in normalized u. */
+struct PowerSums {
+    double s0, s1, s2, s3, s4; // Σuᵏ
+    double t0, t1, t2;         // Σv·uᵏ
+    double vv;                 // Σv²
+
+    int n;                     // points with non-zero weight
+
+    inline void add(double u, double v, double w = 1.0) {
+        if (w <= 0.0) return;
+        const double u2 = u * u;
+        s0 += w;
+        s1 += w * u;
+        s2 += w * u2;
+        s3 += w * u2 * u;
+        s4 += w * u2 * u2;
+        t0 += w * v;
+        t1 += w * v * u;
+        t2 += w * v * u2;
+        vv += w * v * v;
+        ++n;
+    }
+
+    inline PowerSums operator-(const PowerSums &o) const {
+        return {s0 - o.s0, s1 - o.s1, s2 - o.s2, s3 - o.s3, s4 - o.s4,
+                t0 - o.t0, t1 - o.t1, t2 - o.t2, vv - o.vv, n - o.n};
+    }
+};
+
+/** Per-line normalization u = (t - origin) · invScale. */
+struct LineFrame {
+    double origin;
+    double invScale;
+};
+
+inline LineFrame makeFrame(double first, double mid, double last) {
+    double half = 0.5 * std::fabs(last - first);
+    return {mid, half > 1e-6 ? 1.0 / half : 1.0};
+}
+
+/**
+ * Solves the symmetric system [[s4,s3,s2],[s3,s2,s1],[s2,s1,s0]]·θ = [t2,t1,t0]
+ * by cofactor expansion and maps θ back from normalized to image coordinates.
+ */
+QuadraticFit solveFit(const PowerSums &p, const LineFrame &f) {
+    QuadraticFit fit{0.0, 0.0, 0.0, 0.0, p.n, p.n, false};
+    if (p.n < 3) return fit;
+
+    const double c00 = p.s2 * p.s0 - p.s1 * p.s1;
+    const double c01 = p.s2 * p.s1 - p.s3 * p.s0;
+    const double c02 = p.s3 * p.s1 - p.s2 * p.s2;
+    const double c11 = p.s4 * p.s0 - p.s2 * p.s2;
+    const double c12 = p.s3 * p.s2 - p.s4 * p.s1;
+    const double c22 = p.s4 * p.s2 - p.s3 * p.s3;
+
+    const double det = p.s4 * c00 + p.s3 * c01 + p.s2 * c02;
+    if (std::fabs(det) < 1e-12 * (p.s4 * p.s2 * p.s0 + 1e-300)) return fit;
+    const double inv = 1.0 / det;
+
+    const double alpha = (c00 * p.t2 + c01 * p.t1 + c02 * p.t0) * inv;
+    const double beta  = (c01 * p.t2 + c11 * p.t1 + c12 * p.t0) * inv;
+    const double gamma = (c02 * p.t2 + c12 * p.t1 + c22 * p.t0) * inv;
+
+    // SSE = Σv² - 2θᵀ(Aᵀv) + θᵀ(AᵀA)θ, and (AᵀA)θ = Aᵀv at the optimum.
+    const double sse = p.vv - (alpha * p.t2 + beta * p.t1 + gamma * p.t0);
+    fit.rmsResidual = std::sqrt(std::max(0.0, sse) / p.s0);
+
+    // v = α·k²(t-o)² + β·k(t-o) + γ with k = invScale, o = origin
+    const double k = f.invScale, o = f.origin;
+    fit.a = alpha * k * k;
+    fit.b = beta * k - 2.0 * fit.a * o;
+    fit.c = fit.a * o * o - beta * k * o + gamma;
+    fit.valid = true;
+    return fit;
+}
+
+/** One row (t = x, v = y) or column (t = y, v = x) of the corner grid. */
+struct LineView {
+    const Point2f *base;
+    int stride;
+    int n;
+    bool column;
+
+    inline double t(int i) const { return column ? base[i * stride].y : base[i * stride].x; }
+    inline double v(int i) const { return column ? base[i * stride].x : base[i * stride].y; }
+    inline LineFrame frame() const { return makeFrame(t(0), t(n / 2), t(n - 1)); }
+};
+
+inline double evaluate(const QuadraticFit &f, double t) {
+    return (f.a * t + f.b) * t + f.c;
+}
+
+/** Weighted least-squares fit; null weights mean all ones. */
+QuadraticFit fitWeighted(const LineView &line, const float *w) {
+    const LineFrame f = line.frame();
+    PowerSums sums = PowerSums();
+    for (int i = 0; i < line.n; ++i)
+        sums.add((line.t(i) - f.origin) * f.invScale, line.v(i), w ? w[i] : 1.0);
+    QuadraticFit fit = solveFit(sums, f);
+    fit.count = line.n;
+    return fit;
+}
+
+/** Counts inliers and replaces rmsResidual by the RMS over those inliers. */
+void finishRobustFit(const LineView &line, double threshold, QuadraticFit &fit) {
+    if (!fit.valid) return;
+    double sse = 0.0;
+    int inliers = 0;
+    for (int i = 0; i < line.n; ++i) {
+        const double r = line.v(i) - evaluate(fit, line.t(i));
+        if (std::fabs(r) <= threshold) {
+            sse += r * r;
+            ++inliers;
+        }
+    }
+    fit.inliers = inliers;
+    fit.rmsResidual = inliers > 0 ? std::sqrt(sse / inliers) : 0.0;
+}
+
+/** Exact parabola through three points by divided differences. */
+bool parabolaThrough(const LineView &line, int i, int j, int k, QuadraticFit &fit) {
+    const double t0 = line.t(i), t1 = line.t(j), t2 = line.t(k);
+    const double v0 = line.v(i), v1 = line.v(j), v2 = line.v(k);
+    const double d01 = t1 - t0, d02 = t2 - t0, d12 = t2 - t1;
+    if (std::fabs(d01) < 1e-6 || std::fabs(d02) < 1e-6 || std::fabs(d12) < 1e-6) return false;
+
+    const double s01 = (v1 - v0) / d01;
+    const double s12 = (v2 - v1) / d12;
+    fit.a = (s12 - s01) / d02;
+    fit.b = s01 - fit.a * (t0 + t1);
+    fit.c = v0 - (fit.a * t0 + fit.b) * t0;
+    fit.valid = true;
+    return true;
+}
+
+QuadraticFit fitRansac(const LineView &line, const RobustFitParams &params,
+                       const uint16_t *schedule, int hypotheses) {
+    QuadraticFit best = QuadraticFit();
+    int bestInliers = -1;
+    double bestSse = 0.0;
+
+    for (int h = 0; h < hypotheses; ++h) {
+        QuadraticFit cand = QuadraticFit();
+        const uint16_t *idx = schedule + 3 * h;
+        if (!parabolaThrough(line, idx[0], idx[1], idx[2], cand)) continue;
+
+        int inliers = 0;
+        double sse = 0.0;
+        for (int i = 0; i < line.n; ++i) {
+            const double r = line.v(i) - evaluate(cand, line.t(i));
+            if (std::fabs(r) <= params.inlierThreshold) {
+                ++inliers;
+                sse += r * r;
+            }
+        }
+        if (inliers > bestInliers || (inliers == bestInliers && sse < bestSse)) {
+            best = cand;
+            bestInliers = inliers;
+            bestSse = sse;
+        }
+    }
+
+    if (bestInliers < 3) return fitWeighted(line, nullptr);
+
+    AutoBuffer<float, 64> w(line.n);
+    for (int i = 0; i < line.n; ++i) {
+        const double r = line.v(i) - evaluate(best, line.t(i));
+        w[i] = std::fabs(r) <= params.inlierThreshold ? 1.f : 0.f;
+    }
+    QuadraticFit refit = fitWeighted(line, w.data());
+    return refit.valid ? refit : fitWeighted(line, nullptr);
+}
+
+QuadraticFit fitIrls(const LineView &line, const RobustFitParams &params) {
+    QuadraticFit fit = fitWeighted(line, nullptr);
+    if (!fit.valid) return fit;
+
+    AutoBuffer<float, 64> w(line.n);
+    AutoBuffer<float, 64> absRes(line.n);
+    AutoBuffer<float, 64> sorted(line.n);
+    const double tEnd0 = line.t(0), tEnd1 = line.t(line.n - 1);
+
+    for (int it = 0; it < params.irlsIterations; ++it) {
+        for (int i = 0; i < line.n; ++i)
+            absRes[i] = (float) std::fabs(line.v(i) - evaluate(fit, line.t(i)));
+
+        // Robust scale from the median absolute residual, floored so a perfect
+        // fit does not turn every point into an outlier.
+        std::copy(absRes.data(), absRes.data() + line.n, sorted.data());
+        std::nth_element(sorted.data(), sorted.data() + line.n / 2, sorted.data() + line.n);
+        const double sigma = std::max(1.4826 * sorted[line.n / 2], 0.05);
+
+        if (params.mode == FIT_HUBER) {
+            const double k = 1.345 * sigma;
+            for (int i = 0; i < line.n; ++i)
+                w[i] = absRes[i] <= k ? 1.f : (float) (k / absRes[i]);
+        } else {
+            const double c = 4.685 * sigma;
+            for (int i = 0; i < line.n; ++i) {
+                const double q = absRes[i] / c;
+                w[i] = q < 1.0 ? (float) ((1.0 - q * q) * (1.0 - q * q)) : 0.f;
+            }
+        }
+
+        QuadraticFit next = fitWeighted(line, w.data());
+        if (!next.valid) break;
+
+        const double change = std::max(std::fabs(evaluate(next, tEnd0) - evaluate(fit, tEnd0)),
+                                       std::fabs(evaluate(next, tEnd1) - evaluate(fit, tEnd1)));
+        fit = next;
+        if (change < 1e-4) break;
+    }
+    return fit;
+}
+
+/** Deterministic schedule of distinct index triples in [0, n). */
+void buildRansacSchedule(int n, int hypotheses, uint16_t *schedule) {
+    RNG rng(0x5a3c1d2bU + (unsigned) n);
+    for (int h = 0; h < hypotheses; ++h) {
+        uint16_t *idx = schedule + 3 * h;
+        idx[0] = (uint16_t) rng.uniform(0, n);
+        do { idx[1] = (uint16_t) rng.uniform(0, n); } while (idx[1] == idx[0]);
+        do { idx[2] = (uint16_t) rng.uniform(0, n); } while (idx[2] == idx[0] || idx[2] == idx[1]);
+    }
+}
+
+QuadraticFit fitLineRobust(const LineView &line, const RobustFitParams &params,
+                           const uint16_t *schedule, int hypotheses) {
+    QuadraticFit fit = params.mode == FIT_RANSAC
+                       ? fitRansac(line, params, schedule, hypotheses)
+                       : fitIrls(line, params);
+    fit.count = line.n;
+    finishRobustFit(line, params.inlierThreshold, fit);
+    return fit;
+}
+
+// Shortest segment that still leaves a residual degree of freedom per row.
+const int MIN_SEGMENT_COLS = 4;
+
+/** Per-row prefix power sums over the corner columns, for O(rows) segment costs. */
+struct SegmentCosts {
+    const PowerSums *prefix; // rows x (cols + 1)
+    const LineFrame *frames; // per row
+    int cols;
+    int rows;
+
+    inline PowerSums sums(int r, int i, int j) const {
+        return prefix[r * (cols + 1) + j] - prefix[r * (cols + 1) + i];
+    }
+
+    double cost(int i, int j) const {
+        double sse = 0.0;
+        for (int r = 0; r < rows; ++r) {
+            QuadraticFit f = solveFit(sums(r, i, j), frames[r]);
+            if (!f.valid) return std::numeric_limits<double>::infinity();
+            sse += f.rmsResidual * f.rmsResidual * f.count;
+        }
+        return sse;
+    }
+};
+
+/** Noise variance from the MAD of third differences along rows (they cancel any parabola). */
+double estimateRowNoiseVariance(const Point2f *corners, int cols, int rows) {
+    std::vector<float> d3;
+    d3.reserve(std::max(0, cols - 3) * rows);
+    for (int r = 0; r < rows; ++r) {
+        const Point2f *row = corners + r * cols;
+        for (int c = 0; c + 3 < cols; ++c)
+            d3.push_back(std::fabs(row[c + 3].y - 3.f * row[c + 2].y + 3.f * row[c + 1].y - row[c].y));
+    }
+    if (d3.empty()) return 0.0;
+    std::nth_element(d3.begin(), d3.begin() + d3.size() / 2, d3.end());
+    // Var(Δ³y) = 20σ² for i.i.d. noise
+    const double sigma = std::max(1.4826 * d3[d3.size() / 2] / std::sqrt(20.0), 0.02);
+    return sigma * sigma;
+}
+
+} // namespace
+
+void fitGridQuadratics(const Point2f *corners, int cols, int rows,
+                       QuadraticFit *rowFits, QuadraticFit *colFits) {
+    if (!corners || cols <= 0 || rows <= 0) return;
+
+    AutoBuffer<PowerSums, 64> colSums(colFits ? cols : 0);
+    AutoBuffer<LineFrame, 64> colFrames(colFits ? cols : 0);
+    if (colFits) {
+        for (int c = 0; c < cols; ++c) {
+            colSums[c] = PowerSums();
+            colFrames[c] = makeFrame(corners[c].y,
+                                     corners[(rows / 2) * cols + c].y,
+                                     corners[(rows - 1) * cols + c].y);
+        }
+    }
+
+    for (int r = 0; r < rows; ++r) {
+        const Point2f *row = corners + r * cols;
+        const LineFrame rowFrame = makeFrame(row[0].x, row[cols / 2].x, row[cols - 1].x);
+        PowerSums rowSum = PowerSums();
+
+        for (int c = 0; c < cols; ++c) {
+            const Point2f &p = row[c];
+            rowSum.add((p.x - rowFrame.origin) * rowFrame.invScale, p.y);
+            if (colFits)
+                colSums[c].add((p.y - colFrames[c].origin) * colFrames[c].invScale, p.x);
+        }
+
+        if (rowFits) rowFits[r] = solveFit(rowSum, rowFrame);
+    }
+
+    if (colFits) {
+        for (int c = 0; c < cols; ++c)
+            colFits[c] = solveFit(colSums[c], colFrames[c]);
+    }
+}
+
+void fitGridQuadraticsRobust(const Point2f *corners, int cols, int rows,
+                             const RobustFitParams &params,
+                             QuadraticFit *rowFits, QuadraticFit *colFits) {
+    if (params.mode == FIT_LEAST_SQUARES || cols < 4 || rows < 1) {
+        fitGridQuadratics(corners, cols, rows, rowFits, colFits);
+        return;
+    }
+    if (!corners) return;
+
+    // Rows share one schedule (length cols), columns another (length rows).
+    const int hypotheses = std::max(1, params.ransacIterations);
+    const bool ransac = params.mode == FIT_RANSAC;
+    AutoBuffer<uint16_t, 3 * 64> rowSchedule(ransac ? 3 * hypotheses : 0);
+    AutoBuffer<uint16_t, 3 * 64> colSchedule(ransac ? 3 * hypotheses : 0);
+    if (ransac) {
+        buildRansacSchedule(cols, hypotheses, rowSchedule.data());
+        if (rows >= 4) buildRansacSchedule(rows, hypotheses, colSchedule.data());
+    }
+
+    if (rowFits) {
+        for (int r = 0; r < rows; ++r) {
+            LineView line{corners + r * cols, 1, cols, false};
+            rowFits[r] = fitLineRobust(line, params, rowSchedule.data(), hypotheses);
+        }
+    }
+    if (colFits) {
+        for (int c = 0; c < cols; ++c) {
+            LineView line{corners + c, cols, rows, true};
+            colFits[c] = rows >= 4 ? fitLineRobust(line, params, colSchedule.data(), hypotheses)
+                                   : fitWeighted(line, nullptr);
+        }
+    }
+}
+
+int fitSegmentedCurvature(const Point2f *corners, int cols, int rows,
+                          const int *boundaries, int boundaryCount, double penalty,
+                          CurvatureSegment *segments, int maxSegments) {
+    if (!corners || !segments || maxSegments <= 0 || cols < MIN_SEGMENT_COLS || rows < 1)
+        return 0;
+
+    // --- 1️⃣ Prefix power sums for every row, in that row's normalized frame
+    std::vector<PowerSums> prefix(rows * (cols + 1));
+    std::vector<LineFrame> frames(rows);
+    for (int r = 0; r < rows; ++r) {
+        const Point2f *row = corners + r * cols;
+        frames[r] = makeFrame(row[0].x, row[cols / 2].x, row[cols - 1].x);
+        PowerSums acc = PowerSums();
+        prefix[r * (cols + 1)] = acc;
+        for (int c = 0; c < cols; ++c) {
+            acc.add((row[c].x - frames[r].origin) * frames[r].invScale, row[c].y);
+            prefix[r * (cols + 1) + c + 1] = acc;
+        }
+    }
+    const SegmentCosts costs{prefix.data(), frames.data(), cols, rows};
+
+    if (penalty <= 0.0) {
+        // BIC: three parameters per row and segment
+        const double n = (double) cols * rows;
+        penalty = 3.0 * rows * std::log(n) * estimateRowNoiseVariance(corners, cols, rows);
+    }
+
+    // --- 2️⃣ Breakpoint candidates: layout boundaries if given, else every column
+    std::vector<char> allowed(cols + 1, boundaries ? 0 : 1);
+    if (boundaries) {
+        for (int k = 0; k < boundaryCount; ++k)
+            if (boundaries[k] > 0 && boundaries[k] < cols) allowed[boundaries[k]] = 1;
+    }
+    allowed[0] = allowed[cols] = 1;
+
+    // --- 3️⃣ Optimal partitioning with PELT pruning
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> best(cols + 1, INF);
+    std::vector<int> prev(cols + 1, -1);
+    std::vector<int> live{0};
+    std::vector<int> kept;
+    best[0] = -penalty;
+
+    for (int t = MIN_SEGMENT_COLS; t <= cols; ++t) {
+        if (!allowed[t]) continue;
+
+        AutoBuffer<double, 64> segCost(live.size());
+        for (size_t k = 0; k < live.size(); ++k) {
+            const int s0 = live[k];
+            segCost[k] = t - s0 >= MIN_SEGMENT_COLS ? costs.cost(s0, t) : INF;
+            const double total = best[s0] + segCost[k] + penalty;
+            if (total < best[t]) {
+                best[t] = total;
+                prev[t] = s0;
+            }
+        }
+
+        // Drop start points that can never beat t again; too-short ones stay.
+        kept.clear();
+        for (size_t k = 0; k < live.size(); ++k) {
+            const int s0 = live[k];
+            if (t - s0 < MIN_SEGMENT_COLS || best[s0] + segCost[k] <= best[t])
+                kept.push_back(s0);
+        }
+        if (best[t] < INF) kept.push_back(t);
+        live.swap(kept);
+    }
+
+    if (prev[cols] < 0) return 0;
+
+    // --- 4️⃣ Backtrack and describe each segment
+    std::vector<int> cuts;
+    for (int t = cols; t > 0; t = prev[t]) cuts.push_back(t);
+    cuts.push_back(0);
+    std::reverse(cuts.begin(), cuts.end());
+
+    double centreY = 0.0;
+    for (int r = 0; r < rows; ++r) centreY += corners[r * cols + cols / 2].y;
+    centreY /= rows;
+
+    const int count = std::min((int) cuts.size() - 1, maxSegments);
+    for (int k = 0; k < count; ++k) {
+        const int i = cuts[k], j = cuts[k + 1];
+        double radiusSum = 0.0, bowing = 0.0, sse = 0.0;
+        int radiusCount = 0, points = 0;
+
+        for (int r = 0; r < rows; ++r) {
+            QuadraticFit f = solveFit(costs.sums(r, i, j), frames[r]);
+            if (!f.valid) continue;
+            sse += f.rmsResidual * f.rmsResidual * f.count;
+            points += f.count;
+
+            const double radius = radiusFromQuadratic(f);
+            if (radius > 0.0) {
+                radiusSum += radius;
+                ++radiusCount;
+            }
+            // Rows above the centre bow up (a < 0) and rows below bow down (a > 0)
+            // when the wall is concave towards the camera.
+            const double side = corners[r * cols + (i + j) / 2].y - centreY;
+            bowing += (side >= 0.0 ? 1.0 : -1.0) * f.a;
+        }
+
+        CurvatureSegment &seg = segments[k];
+        seg.startCol = i;
+        seg.endCol = j;
+        seg.radius = radiusCount > 0 ? radiusSum / radiusCount : 0.0;
+        if (bowing < 0.0) seg.radius = -seg.radius;
+        seg.rmsResidual = points > 0 ? std::sqrt(sse / points) : 0.0;
+    }
+    return count;
+}
+
+bool fitQuadricSurface(const Point2f *corners, int cols, int rows, SurfaceFit &fit) {
+    fit = SurfaceFit();
+    fit.horizontalRadius = fit.verticalRadius = -1.0;
+    if (!corners || cols < 3 || rows < 3) return false;
+
+    const double u0 = 0.5 * (cols - 1), v0 = 0.5 * (rows - 1);
+    Matx<double, 6, 6> AtA = Matx<double, 6, 6>::zeros();
+    Matx<double, 6, 2> Atb = Matx<double, 6, 2>::zeros();
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const double u = c - u0, v = r - v0;
+            const double phi[6] = {1.0, u, v, u * u, u * v, v * v};
+            const Point2f &p = corners[r * cols + c];
+            for (int i = 0; i < 6; ++i) {
+                Atb(i, 0) += phi[i] * p.x;
+                Atb(i, 1) += phi[i] * p.y;
+                for (int j = i; j < 6; ++j) AtA(i, j) += phi[i] * phi[j];
+            }
+        }
+    }
+    for (int i = 0; i < 6; ++i)
+        for (int j = 0; j < i; ++j) AtA(i, j) = AtA(j, i);
+
+    Matx<double, 6, 2> coef;
+    if (!solve(AtA, Atb, coef, DECOMP_CHOLESKY)) return false;
+    for (int i = 0; i < 6; ++i) {
+        fit.x[i] = coef(i, 0);
+        fit.y[i] = coef(i, 1);
+    }
+    const double *X = fit.x, *Y = fit.y;
+
+    double sse = 0.0;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const double u = c - u0, v = r - v0;
+            const double px = X[0] + X[1] * u + X[2] * v + X[3] * u * u + X[4] * u * v + X[5] * v * v;
+            const double py = Y[0] + Y[1] * u + Y[2] * v + Y[3] * u * u + Y[4] * u * v + Y[5] * v * v;
+            const Point2f &p = corners[r * cols + c];
+            sse += (px - p.x) * (px - p.x) + (py - p.y) * (py - p.y);
+        }
+    }
+    fit.rmsResidual = std::sqrt(sse / (cols * rows));
+
+    // Curvature of a parametric curve: |x'y'' - y'x''| / (x'² + y'²)^(3/2).
+    // Along a row (v fixed) at its centre: x' = X1 + X4·v, x'' = 2·X3 (same for y).
+    double rowCurv = 0.0;
+    for (int r = 0; r < rows; ++r) {
+        const double v = r - v0;
+        const double dx = X[1] + X[4] * v, dy = Y[1] + Y[4] * v;
+        const double speed = std::sqrt(dx * dx + dy * dy);
+        if (speed > 1e-9) rowCurv += std::fabs(dx * 2.0 * Y[3] - dy * 2.0 * X[3]) / (speed * speed * speed);
+    }
+    // Along a column (u fixed): x' = X2 + X4·u, x'' = 2·X5.
+    double colCurv = 0.0;
+    for (int c = 0; c < cols; ++c) {
+        const double u = c - u0;
+        const double dx = X[2] + X[4] * u, dy = Y[2] + Y[4] * u;
+        const double speed = std::sqrt(dx * dx + dy * dy);
+        if (speed > 1e-9) colCurv += std::fabs(dx * 2.0 * Y[5] - dy * 2.0 * X[5]) / (speed * speed * speed);
+    }
+    rowCurv /= rows;
+    colCurv /= cols;
+    if (rowCurv > 1e-12) fit.horizontalRadius = 1.0 / rowCurv;
+    if (colCurv > 1e-12) fit.verticalRadius = 1.0 / colCurv;
+
+    fit.valid = true;
+    return true;
+}
+
+double radiusFromQuadratic(const QuadraticFit &fit) {
+    if (!fit.valid || std::fabs(fit.a) <= 1e-9) return -1.0;
+    return 1.0 / (2.0 * std::fabs(fit.a));
+}
+
+static float *packLine(float *dst, const QuadraticFit *fit) {
+    if (fit && fit->valid) {
+        dst[0] = (float) radiusFromQuadratic(*fit);
+        dst[1] = (float) fit->a;
+        dst[2] = (float) fit->b;
+        dst[3] = (float) fit->c;
+        dst[4] = (float) fit->rmsResidual;
+        dst[5] = (float) fit->inliers;
+    } else {
+        dst[0] = -1.f;
+        dst[1] = dst[2] = dst[3] = dst[4] = dst[5] = 0.f;
+    }
+    return dst + CURVATURE_RESULT_STRIDE;
+}
+
+void packCurvatureResult(float *out, bool found, double meanRadius,
+                         const QuadraticFit *rowFits, int rows,
+                         const QuadraticFit *colFits, int cols) {
+    out[0] = found ? 1.f : 0.f;
+    out[1] = (float) meanRadius;
+    out[2] = (float) rows;
+    out[3] = (float) cols;
+
+    float *dst = out + CURVATURE_RESULT_HEADER;
+    for (int r = 0; r < rows; ++r) dst = packLine(dst, rowFits ? rowFits + r : nullptr);
+    for (int c = 0; c < cols; ++c) dst = packLine(dst, colFits ? colFits + c : nullptr);
+}
@@ -0,0 +1,167 @@
+#ifndef CURVATURE_FIT_H
+#define CURVATURE_FIT_H
+
+#include <opencv2/core.hpp>
+
+/**
+ * Least-squares parabola v = a·t² + b·t + c in image coordinates.
+ *
+ * Row fits use t = x, v = y; column fits use t = y, v = x.
+ */
+struct QuadraticFit {
+    double a;
+    double b;
+    double c;
+    double rmsResidual; // RMS of v - fit(t) over the fitted points (inliers in robust modes), pixels
+    int count;          // number of points on the line
+    int inliers;        // points within the inlier threshold (= count for plain least squares)
+    bool valid;         // false when fewer than 3 points or a singular system
+};
+
+/**
+ * Line fitting modes, mirrored by the FIT_* constants in ChessBoardManager.kt.
+ */
+enum FitMode {
+    FIT_LEAST_SQUARES = 0, // plain closed-form least squares
+    FIT_RANSAC = 1,        // 3-point parabola hypotheses, refit on the best consensus set
+    FIT_HUBER = 2,         // IRLS with Huber weights
+    FIT_TUKEY = 3          // IRLS with Tukey biweight, fully rejects far outliers
+};
+
+/**
+ * Parameters for fitGridQuadraticsRobust. Iteration counts are hard upper
+ * bounds, so the worst-case latency is fixed by the grid size.
+ */
+struct RobustFitParams {
+    int mode = FIT_LEAST_SQUARES;
+    double inlierThreshold = 0.5; // pixels, |v - fit(t)| counted as inlier
+    int ransacIterations = 64;    // hypotheses per line
+    int irlsIterations = 10;      // reweighting passes per line
+};
+
+/**
+ * Fits a parabola to every row and every column of a detected corner grid.
+ *
+ * Power sums for all rows and columns are accumulated in a single pass over the
+ * row-major corner array (as returned by findChessboardCorners). Each 3x3 normal
+ * system is then solved in closed form. Coordinates are centred and scaled per
+ * line before accumulation so the sums stay well conditioned on large frames.
+ * Accumulators live on the stack for grids up to 64 columns; nothing is
+ * allocated in that case.
+ *
+ * @param corners Row-major corner array of size cols·rows.
+ * @param cols    Inner corners per row.
+ * @param rows    Inner corners per column.
+ * @param rowFits Output array of size rows (may be nullptr to skip).
+ * @param colFits Output array of size cols (may be nullptr to skip).
+ */
+void fitGridQuadratics(const cv::Point2f *corners, int cols, int rows,
+                       QuadraticFit *rowFits, QuadraticFit *colFits);
+
+/**
+ * Robust variant of fitGridQuadratics.
+ *
+ * RANSAC draws minimal 3-point parabolas from a random index schedule that is
+ * generated once per line length with a fixed seed and shared by all rows (and
+ * all columns), then refits on the largest consensus set. Huber and Tukey run
+ * IRLS from the least-squares start, reusing the closed-form 3x3 solve with
+ * weighted power sums and a MAD scale estimate. FIT_LEAST_SQUARES forwards to
+ * fitGridQuadratics. Inlier counts are reported per line in every mode.
+ */
+void fitGridQuadraticsRobust(const cv::Point2f *corners, int cols, int rows,
+                             const RobustFitParams &params,
+                             QuadraticFit *rowFits, QuadraticFit *colFits);
+
+/**
+ * One piece of a segmented (piecewise-radius) wall, in corner-column indices.
+ */
+struct CurvatureSegment {
+    int startCol;        // first corner column of the segment
+    int endCol;          // one past the last corner column
+    double radius;       // mean row radius in pixels, signed: positive when rows bow away from
+                         // the grid's centre row (concave towards the camera), negative for convex;
+                         // 0 when every row is flat
+    double rmsResidual;  // RMS of the per-row segment fits, pixels
+};
+
+/**
+ * Splits the corner columns into segments with independent row parabolas.
+ *
+ * Per-row prefix power sums make the cost of any candidate segment O(rows).
+ * Optimal partitioning with a per-segment penalty is solved by dynamic
+ * programming with PELT pruning, which runs in expected linear time in the
+ * corner count.
+ *
+ * @param corners     Row-major corner array of size cols·rows.
+ * @param cols        Inner corners per row.
+ * @param rows        Inner corners per column.
+ * @param boundaries  Allowed breakpoints as corner-column indices (e.g. cabinet
+ *                    edges from the layout), or nullptr to allow any column.
+ * @param boundaryCount Number of entries in @p boundaries.
+ * @param penalty     Cost added per segment in squared pixels; <= 0 derives a
+ *                    BIC-style penalty from a noise estimate on third differences.
+ * @param segments    Output array.
+ * @param maxSegments Capacity of @p segments.
+ * @return            Number of segments written, 0 if the grid is too small.
+ */
+int fitSegmentedCurvature(const cv::Point2f *corners, int cols, int rows,
+                          const int *boundaries, int boundaryCount, double penalty,
+                          CurvatureSegment *segments, int maxSegments);
+
+/**
+ * Full 2D quadric model of the corner grid in corner units (u, v), centred on
+ * the grid: x = Σ xᵢ·φᵢ(u,v), y = Σ yᵢ·φᵢ(u,v) with φ = [1, u, v, u², uv, v²].
+ */
+struct SurfaceFit {
+    double x[6];
+    double y[6];
+    double horizontalRadius; // 1 / mean row curvature in pixels, -1 if rows are straight
+    double verticalRadius;   // 1 / mean column curvature in pixels, -1 if columns are straight
+    double rmsResidual;      // RMS corner distance to the surface, pixels
+    bool valid;
+};
+
+/**
+ * Fits a quadric surface to all corners at once and derives horizontal and
+ * vertical radii for dome/barrel walls.
+ *
+ * Row and column curvatures are the exact curvatures of the parametric
+ * curves v = const and u = const, averaged over the grid's rows and columns.
+ * x and y share one 6x6 normal matrix, so the solve is a single Cholesky
+ * factorisation with two right-hand sides.
+ */
+bool fitQuadricSurface(const cv::Point2f *corners, int cols, int rows, SurfaceFit &fit);
+
+/**
+ * Osculating radius 1 / (2|a|) at the vertex of a fitted parabola.
+ *
+ * @return Radius in pixels, or -1 when the fit is invalid or flat.
+ */
+double radiusFromQuadratic(const QuadraticFit &fit);
+
+/**
+ * Float layout of a packed curvature result, shared with CurvatureResult.kt:
+ *
+ *   [0] found (1/0)   [1] mean row radius (px, -1 if none)   [2] rows   [3] cols
+ *   then `rows` row records followed by `cols` column records, each
+ *   [radius (px, -1 if flat/invalid), a, b, c, rmsResidual, inliers].
+ */
+enum CurvatureResultLayout {
+    CURVATURE_RESULT_HEADER = 4,
+    CURVATURE_RESULT_STRIDE = 6
+};
+
+inline int curvatureResultFloats(int cols, int rows) {
+    return CURVATURE_RESULT_HEADER + CURVATURE_RESULT_STRIDE * (rows + cols);
+}
+
+/**
+ * Writes a packed curvature result into @p out, which must hold
+ * curvatureResultFloats(cols, rows) floats. Null fit arrays are written as
+ * invalid records.
+ */
+void packCurvatureResult(float *out, bool found, double meanRadius,
+                         const QuadraticFit *rowFits, int rows,
+                         const QuadraticFit *colFits, int cols);
+
+#endif // CURVATURE_FIT_H
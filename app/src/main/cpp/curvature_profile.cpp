@@ -0,0 +1,61 @@
+#include "curvature_profile.h"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace cv;
+
+void computeCurvatureProfile(int width, float radius, float *out) {
+    const float half = width / 2.0f;
+    const float r2 = radius * radius;
+    int x = 0;
+
+    // v_sqrt is only an estimate refined by Newton steps on 32-bit NEON; the
+    // vector body is used where it is IEEE sqrt, so every lane matches the tail.
+#if CV_SIMD128 && (!CV_NEON || CV_NEON_AARCH64)
+    const v_float32x4 vR = v_setall_f32(radius), vR2 = v_setall_f32(r2);
+    const v_float32x4 vZero = v_setzero_f32(), vStep = v_setall_f32(4.0f);
+    v_float32x4 dx(-half, 1.0f - half, 2.0f - half, 3.0f - half);
+    for (; x <= width - 4; x += 4) {
+        const v_float32x4 t = v_max(v_sub(vR2, v_mul(dx, dx)), vZero);
+        v_store(out + x, v_sub(vR, v_sqrt(t)));
+        dx = v_add(dx, vStep);
+    }
+#endif
+
+    for (; x < width; ++x) {
+        const float dx = x - half;
+        const float dx2 = dx * dx; // separate statement: no fused multiply-subtract, as in the vector body
+        out[x] = radius - std::sqrt(std::max(r2 - dx2, 0.0f));
+    }
+}
+
+CurvatureProfile::CurvatureProfile(int width, int height, float radius) : height_(height) {
+    CV_Assert(width > 0 && height > 0);
+
+    profile_.create(1, width, CV_32F);
+    computeCurvatureProfile(width, radius, profile_.ptr<float>());
+
+    // Min/max of the profile equal those of the full map, so this matches
+    // normalizing the H x W Mat.
+    normalize(profile_, profile_, 0, 1, NORM_MINMAX);
+}
+
+const Mat &CurvatureProfile::dense() {
+    std::call_once(denseOnce_, [this] {
+        Mat map(height_, profile_.cols, CV_32F);
+        const size_t rowBytes = profile_.cols * sizeof(float);
+        parallel_for_(Range(0, height_), [&](const Range &range) {
+            for (int y = range.start; y < range.end; ++y)
+                std::memcpy(map.ptr<float>(y), profile_.ptr<float>(), rowBytes);
+        });
+        dense_ = map;
+    });
+    return dense_;
+}
+
+size_t CurvatureProfile::bytes() const {
+    return profile_.total() * profile_.elemSize() + dense_.total() * dense_.elemSize();
+}
@@ -0,0 +1,52 @@
+#ifndef CURVATURE_PROFILE_H
+#define CURVATURE_PROFILE_H
+
+#include <opencv2/core.hpp>
+#include <mutex>
+
+/**
+ * Writes the raw curvature height z(x) = R - sqrt(R² - (x - w/2)²) for
+ * x = 0..width-1 into @p out, vectorized with universal intrinsics. Columns
+ * beyond |x - w/2| > R are clamped to the rim height R.
+ */
+void computeCurvatureProfile(int width, float radius, float *out);
+
+/**
+ * Normalized curvature height map of a cylindrical wall,
+ * z(x) = R - sqrt(R² - (x - w/2)²) scaled to [0, 1] (NORM_MINMAX), kept as
+ * its single 1 x W row.
+ *
+ * The map is constant down every column, so at() and row() broadcast the
+ * profile to any row without storing H copies. dense() materializes the
+ * H x W CV_32F Mat only when a consumer really needs one, filling rows in
+ * parallel; it is built once and then shared. Columns beyond |x - w/2| > R
+ * are clamped to the rim height instead of producing NaN.
+ */
+class CurvatureProfile {
+public:
+    CurvatureProfile(int width, int height, float radius);
+
+    int width() const { return profile_.cols; }
+    int height() const { return height_; }
+
+    /** The 1 x W CV_32F profile. */
+    const cv::Mat &profile() const { return profile_; }
+
+    /** Broadcast view: every row of the map is the profile. */
+    const float *row(int /*y*/) const { return profile_.ptr<float>(); }
+    float at(int /*y*/, int x) const { return profile_.ptr<float>()[x]; }
+
+    /** H x W map, built on first use (thread-safe) and cached. */
+    const cv::Mat &dense();
+
+    /** Bytes currently held: the profile plus the dense map once materialized. */
+    size_t bytes() const;
+
+private:
+    int height_;
+    cv::Mat profile_;
+    cv::Mat dense_;
+    std::once_flag denseOnce_;
+};
+
+#endif // CURVATURE_PROFILE_H
@@ -0,0 +1,310 @@
+#include "cylinder_fit.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace cv;
+
+namespace {
+
+enum Param {
+    P_KAPPA, P_YAW, P_PITCH, P_PERSP, P_SCALE, P_ASPECT, P_ROLL, P_TX, P_TY, P_COUNT
+};
+
+const int N = P_COUNT;
+
+/**
+ * Projects arc/height coordinates (u, v) through the model and, when @p jx / @p jy
+ * are given, writes the partial derivatives of x and y with respect to every
+ * parameter.
+ */
+inline void project(const double *p, double u, double v,
+                    double &x, double &y, double *jx, double *jy) {
+    const double k = p[P_KAPPA];
+    const double cy = std::cos(p[P_YAW]), sy = std::sin(p[P_YAW]);
+    const double cp = std::cos(p[P_PITCH]), sp = std::sin(p[P_PITCH]);
+    const double cr = std::cos(p[P_ROLL]), sr = std::sin(p[P_ROLL]);
+    const double mu = p[P_PERSP], s = p[P_SCALE], alpha = p[P_ASPECT];
+
+    // --- Point on the cylinder and its κ-derivative (series near κ = 0)
+    double xw, zw, dxw, dzw;
+    const double ku = k * u;
+    if (std::fabs(ku) < 1e-4) {
+        const double u2 = u * u, u3 = u2 * u, u4 = u2 * u2;
+        xw = u - k * k * u3 / 6.0;
+        zw = k * u2 / 2.0 - k * k * k * u4 / 24.0;
+        dxw = -k * u3 / 3.0;
+        dzw = u2 / 2.0 - k * k * u4 / 8.0;
+    } else {
+        const double sk = std::sin(ku), ck = std::cos(ku);
+        xw = sk / k;
+        zw = (1.0 - ck) / k;
+        dxw = (ku * ck - sk) / (k * k);
+        dzw = (ku * sk - (1.0 - ck)) / (k * k);
+    }
+    const double yw = alpha * v;
+
+    // --- Yaw about the cylinder axis, then pitch about the horizontal axis
+    const double x1 = xw * cy + zw * sy;
+    const double z1 = -xw * sy + zw * cy;
+    const double x2 = x1;
+    const double y2 = yw * cp - z1 * sp;
+    const double z2 = yw * sp + z1 * cp;
+
+    // --- Perspective projection, roll and translation
+    const double w = 1.0 - mu * z2;
+    const double iw = 1.0 / w;
+    const double px = s * x2 * iw;
+    const double py = s * y2 * iw;
+    x = p[P_TX] + px * cr - py * sr;
+    y = p[P_TY] + px * sr + py * cr;
+
+    if (!jx) return;
+
+    // d(px, py) for a change (dx2, dy2, dz2) of the rotated point
+    auto chain = [&](double dx2, double dy2, double dz2, int idx) {
+        const double dpx = s * (dx2 + x2 * mu * dz2 * iw) * iw;
+        const double dpy = s * (dy2 + y2 * mu * dz2 * iw) * iw;
+        jx[idx] = dpx * cr - dpy * sr;
+        jy[idx] = dpx * sr + dpy * cr;
+    };
+
+    const double dx1k = dxw * cy + dzw * sy;
+    const double dz1k = -dxw * sy + dzw * cy;
+    chain(dx1k, -dz1k * sp, dz1k * cp, P_KAPPA);
+    chain(z1, x1 * sp, -x1 * cp, P_YAW);
+    chain(0.0, -z2, y2, P_PITCH);
+    chain(0.0, v * cp, v * sp, P_ASPECT);
+
+    const double dpxMu = s * x2 * z2 * iw * iw, dpyMu = s * y2 * z2 * iw * iw;
+    jx[P_PERSP] = dpxMu * cr - dpyMu * sr;
+    jy[P_PERSP] = dpxMu * sr + dpyMu * cr;
+
+    const double dpxS = x2 * iw, dpyS = y2 * iw;
+    jx[P_SCALE] = dpxS * cr - dpyS * sr;
+    jy[P_SCALE] = dpxS * sr + dpyS * cr;
+
+    jx[P_ROLL] = -px * sr - py * cr;
+    jy[P_ROLL] = px * cr - py * sr;
+    jx[P_TX] = 1.0;
+    jy[P_TX] = 0.0;
+    jx[P_TY] = 0.0;
+    jy[P_TY] = 1.0;
+}
+
+/** Sum of squared residuals; optionally accumulates JᵀJ (upper triangle) and Jᵀr. */
+double accumulate(const double *p, const Point2f *corners, int cols, int rows,
+                  double *JtJ, double *Jtr) {
+    double jx[N], jy[N];
+    const double u0 = 0.5 * (cols - 1), v0 = 0.5 * (rows - 1);
+    double sse = 0.0;
+
+    if (JtJ) {
+        std::fill(JtJ, JtJ + N * N, 0.0);
+        std::fill(Jtr, Jtr + N, 0.0);
+    }
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            double x, y;
+            project(p, c - u0, r - v0, x, y, JtJ ? jx : nullptr, jy);
+            const Point2f &o = corners[r * cols + c];
+            const double rx = x - o.x, ry = y - o.y;
+            sse += rx * rx + ry * ry;
+
+            if (!JtJ) continue;
+            for (int i = 0; i < N; ++i) {
+                Jtr[i] += jx[i] * rx + jy[i] * ry;
+                for (int j = i; j < N; ++j)
+                    JtJ[i * N + j] += jx[i] * jx[j] + jy[i] * jy[j];
+            }
+        }
+    }
+    return sse;
+}
+
+/** In-place Cholesky solve of the symmetric positive-definite system A·x = b. */
+bool choleskySolve(double *A, double *b) {
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            double sum = A[i * N + j];
+            for (int k = 0; k < j; ++k) sum -= A[i * N + k] * A[j * N + k];
+            if (i == j) {
+                if (sum <= 0.0) return false;
+                A[i * N + i] = std::sqrt(sum);
+            } else {
+                A[i * N + j] = sum / A[j * N + j];
+            }
+        }
+    }
+    for (int i = 0; i < N; ++i) {
+        double sum = b[i];
+        for (int k = 0; k < i; ++k) sum -= A[i * N + k] * b[k];
+        b[i] = sum / A[i * N + i];
+    }
+    for (int i = N - 1; i >= 0; --i) {
+        double sum = b[i];
+        for (int k = i + 1; k < N; ++k) sum -= A[k * N + i] * b[k];
+        b[i] = sum / A[i * N + i];
+    }
+    return true;
+}
+
+/** Initial guess from the mean grid steps: flat, frontal, no perspective. */
+void initialGuess(const Point2f *corners, int cols, int rows, double *p, bool &flipV) {
+    Point2d du(0, 0), dv(0, 0), centre(0, 0);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const Point2f &q = corners[r * cols + c];
+            centre += Point2d(q.x, q.y);
+            if (c + 1 < cols) du += Point2d(corners[r * cols + c + 1] - q);
+            if (r + 1 < rows) dv += Point2d(corners[(r + 1) * cols + c] - q);
+        }
+    }
+    centre *= 1.0 / (cols * rows);
+    du *= 1.0 / ((cols - 1) * rows);
+    dv *= 1.0 / (cols * (rows - 1));
+
+    const double su = std::sqrt(du.dot(du));
+    flipV = du.cross(dv) < 0.0;
+
+    std::fill(p, p + N, 0.0);
+    p[P_KAPPA] = 1e-3;
+    p[P_SCALE] = su;
+    p[P_ASPECT] = su > 0.0 ? std::sqrt(dv.dot(dv)) / su : 1.0;
+    p[P_ROLL] = std::atan2(du.y, du.x);
+    p[P_TX] = centre.x;
+    p[P_TY] = centre.y;
+}
+
+} // namespace
+
+bool fitCylinder(const Point2f *corners, int cols, int rows, CylinderFit &fit,
+                 int maxIterations, bool warmStart) {
+    if (!corners || cols < 3 || rows < 2) return false;
+
+    // A mirrored grid order (rows detected bottom-up) is handled by flipping v
+    // through a negative aspect, keeping the model a proper rotation.
+    double p[N];
+    bool flipV = false;
+    initialGuess(corners, cols, rows, p, flipV);
+    if (flipV) p[P_ASPECT] = -p[P_ASPECT];
+    if (warmStart && fit.scale > 0.0 && fit.converged) {
+        p[P_KAPPA] = fit.curvature;
+        p[P_YAW] = fit.yaw;
+        p[P_PITCH] = fit.pitch;
+        p[P_PERSP] = fit.perspective;
+        p[P_SCALE] = fit.scale;
+        p[P_ASPECT] = fit.aspect;
+        p[P_ROLL] = fit.roll;
+        p[P_TX] = fit.tx;
+        p[P_TY] = fit.ty;
+    }
+
+    double JtJ[N * N], Jtr[N], A[N * N], delta[N], trial[N];
+    double sse = accumulate(p, corners, cols, rows, JtJ, Jtr);
+    double lambda = 1e-3;
+    bool converged = false;
+    int it = 0;
+
+    for (; it < maxIterations && !converged; ++it) {
+        bool improved = false;
+        while (!improved && lambda < 1e12) {
+            for (int i = 0; i < N; ++i) {
+                for (int j = i; j < N; ++j) A[i * N + j] = A[j * N + i] = JtJ[i * N + j];
+                A[i * N + i] += lambda * (JtJ[i * N + i] + 1e-9);
+                delta[i] = -Jtr[i];
+            }
+            if (!choleskySolve(A, delta)) {
+                lambda *= 10.0;
+                continue;
+            }
+
+            for (int i = 0; i < N; ++i) trial[i] = p[i] + delta[i];
+            const double trialSse = accumulate(trial, corners, cols, rows, nullptr, nullptr);
+            if (std::isfinite(trialSse) && trialSse < sse) {
+                const double gain = (sse - trialSse) / std::max(sse, 1e-30);
+                std::copy(trial, trial + N, p);
+                sse = accumulate(p, corners, cols, rows, JtJ, Jtr);
+                lambda = std::max(lambda * 0.3, 1e-12);
+                improved = true;
+                converged = gain < 1e-10;
+            } else {
+                lambda *= 4.0;
+            }
+        }
+        if (!improved) converged = true; // no descent direction left at any damping
+    }
+
+    // Negating κ, yaw, pitch and μ together mirrors the wall in depth and
+    // projects identically; a camera in front of the wall has μ ≥ 0, which
+    // fixes the sign of κ.
+    if (p[P_PERSP] < 0.0) {
+        for (int i : {P_KAPPA, P_YAW, P_PITCH, P_PERSP}) p[i] = -p[i];
+        sse = accumulate(p, corners, cols, rows, JtJ, Jtr);
+    }
+
+    const int dof = 2 * cols * rows - N;
+    fit.rmsError = std::sqrt(sse / (cols * rows));
+    fit.curvature = p[P_KAPPA];
+    fit.yaw = p[P_YAW];
+    fit.pitch = p[P_PITCH];
+    fit.perspective = p[P_PERSP];
+    fit.scale = p[P_SCALE];
+    fit.aspect = p[P_ASPECT];
+    fit.roll = p[P_ROLL];
+    fit.tx = p[P_TX];
+    fit.ty = p[P_TY];
+    fit.iterations = it;
+    fit.converged = converged;
+    fit.radius = -1.0;
+    fit.radiusStd = -1.0;
+
+    const double k = std::fabs(p[P_KAPPA]);
+    if (k < 1e-9 || !std::isfinite(sse)) return std::isfinite(sse);
+    fit.radius = std::fabs(p[P_SCALE]) / k;
+
+    // --- Confidence: σ² (JᵀJ)⁻¹ propagated to R = s / |κ|
+    if (dof > 0) {
+        const double sigma2 = sse / dof;
+        double g[N] = {0};
+        g[P_KAPPA] = -fit.radius / p[P_KAPPA];
+        g[P_SCALE] = (p[P_SCALE] < 0 ? -1.0 : 1.0) / k;
+
+        for (int i = 0; i < N; ++i)
+            for (int j = i; j < N; ++j) A[i * N + j] = A[j * N + i] = JtJ[i * N + j];
+        std::copy(g, g + N, delta);
+        if (choleskySolve(A, delta)) {
+            double var = 0.0;
+            for (int i = 0; i < N; ++i) var += g[i] * delta[i];
+            fit.radiusStd = std::sqrt(std::max(0.0, var * sigma2));
+        }
+    }
+    return true;
+}
+
+void packCylinderFit(const CylinderFit &fit, float *out) {
+    const double values[CYLINDER_RESULT_FLOATS] = {
+            fit.radius, fit.radiusStd, fit.rmsError, fit.curvature,
+            fit.roll, fit.pitch, fit.yaw, fit.perspective,
+            fit.scale, fit.aspect, fit.tx, fit.ty, fit.converged ? 1.0 : 0.0
+    };
+    for (int i = 0; i < CYLINDER_RESULT_FLOATS; ++i) out[i] = (float) values[i];
+}
+
+void unpackCylinderFit(const float *in, CylinderFit &fit) {
+    fit = CylinderFit();
+    fit.radius = in[0];
+    fit.radiusStd = in[1];
+    fit.rmsError = in[2];
+    fit.curvature = in[3];
+    fit.roll = in[4];
+    fit.pitch = in[5];
+    fit.yaw = in[6];
+    fit.perspective = in[7];
+    fit.scale = in[8];
+    fit.aspect = in[9];
+    fit.tx = in[10];
+    fit.ty = in[11];
+    fit.converged = in[12] != 0.f;
+}
@@ -0,0 +1,58 @@
+#ifndef CYLINDER_FIT_H
+#define CYLINDER_FIT_H
+
+#include <opencv2/core.hpp>
+
+/**
+ * Joint cylinder-surface model fitted to the whole corner grid.
+ *
+ * Corner (r, c) sits at arc coordinate u = c - (cols-1)/2 and height
+ * v = r - (rows-1)/2 on a cylinder of curvature κ (in corner spacings⁻¹).
+ * The surface is rotated by yaw and pitch, projected with perspective strength
+ * μ and scale s, then rolled and translated in the image.
+ */
+struct CylinderFit {
+    double radius;      // cylinder radius in image pixels at the apex (s / |κ|), -1 if flat or failed
+    double radiusStd;   // 1-sigma uncertainty of radius from the fit covariance, pixels
+    double rmsError;    // reprojection RMS over all corners, pixels
+    double curvature;   // signed κ, positive when the wall is concave towards the camera
+    double roll;        // in-image angle of the cylinder arc direction, radians
+    double pitch;       // rotation about the horizontal axis, radians
+    double yaw;         // rotation about the cylinder axis, radians
+    double perspective; // μ = 1 / (camera distance in corner spacings)
+    double scale;       // s, image pixels per corner spacing at the apex
+    double aspect;      // vertical / horizontal corner spacing on the wall
+    double tx, ty;      // image position of the grid centre on the surface
+    int iterations;     // Levenberg–Marquardt iterations performed
+    bool converged;
+};
+
+/**
+ * Fits the cylinder model to a row-major corner grid with a Levenberg–Marquardt
+ * solver and analytic Jacobians.
+ *
+ * The 9x9 normal equations are accumulated corner by corner in fixed-size
+ * stack storage, so the solve allocates nothing regardless of grid size.
+ *
+ * @param corners       Row-major corner array of size cols·rows.
+ * @param cols          Inner corners per row.
+ * @param rows          Inner corners per column.
+ * @param fit           Output parameters; also read as the initial guess when @p warmStart is set.
+ * @param maxIterations Upper bound on LM iterations, bounding worst-case latency.
+ * @param warmStart     Start from the parameters already in @p fit (e.g. the previous live frame).
+ * @return              false if the grid is too small or the solve diverged.
+ */
+bool fitCylinder(const cv::Point2f *corners, int cols, int rows, CylinderFit &fit,
+                 int maxIterations = 50, bool warmStart = false);
+
+/**
+ * Float layout used to exchange a CylinderFit with Kotlin (ChessBoardManager):
+ * radius, radiusStd, rmsError, curvature, roll, pitch, yaw, perspective,
+ * scale, aspect, tx, ty, converged (1/0).
+ */
+static const int CYLINDER_RESULT_FLOATS = 13;
+
+void packCylinderFit(const CylinderFit &fit, float *out);
+void unpackCylinderFit(const float *in, CylinderFit &fit);
+
+#endif // CYLINDER_FIT_H
@@ -0,0 +1,567 @@
+#include "flatten_warp.h"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "trace_spans.h"
+
+using namespace cv;
+
+/**
+ * Fills @p profile (1 x n, CV_32F) with R·sin((i - c)/R) + c, or the identity
+ * i when R <= 0.
+ */
+static void buildSinProfile(int n, float radius, Mat &profile) {
+    profile.create(1, n, CV_32F);
+    float *p = profile.ptr<float>();
+    const float centre = n / 2.0f;
+
+    if (radius <= 0.0f) {
+        for (int i = 0; i < n; ++i) p[i] = (float) i;
+        return;
+    }
+
+    Mat angle(1, n, CV_32F), magnitude(1, n, CV_32F, Scalar(radius)), cosPart;
+    float *a = angle.ptr<float>();
+    for (int i = 0; i < n; ++i) a[i] = (i - centre) / radius;
+
+    // polarToCart is SIMD-accelerated; angles are in radians.
+    polarToCart(magnitude, angle, cosPart, profile, false);
+    profile += Scalar(centre);
+}
+
+void buildDomeFlattenMaps(Size size, float radiusH, float radiusV, Mat &mapX, Mat &mapY) {
+    Mat colProfile, rowProfile;
+    buildSinProfile(size.width, radiusH, colProfile);
+    buildSinProfile(size.height, radiusV, rowProfile);
+
+    mapX.create(size, CV_32FC1);
+    mapY.create(size, CV_32FC1);
+
+    parallel_for_(Range(0, size.height), [&](const Range &range) {
+        const float *px = colProfile.ptr<float>();
+        const float *py = rowProfile.ptr<float>();
+        for (int y = range.start; y < range.end; ++y) {
+            std::copy(px, px + size.width, mapX.ptr<float>(y));
+            std::fill(mapY.ptr<float>(y), mapY.ptr<float>(y) + size.width, py[y]);
+        }
+    });
+}
+
+/**
+ * Source coordinate R·sin((X - c)/R) + c of n output samples
+ * X = start + i·step, with c = full / 2; identity when R <= 0.
+ */
+static void viewportProfile(int n, float start, float step, int full, float radius, float *out) {
+    const float centre = full / 2.0f;
+    for (int i = 0; i < n; ++i) {
+        const float X = start + i * step;
+        out[i] = radius > 0.0f ? radius * std::sin((X - centre) / radius) + centre : X;
+    }
+}
+
+Rect warpFlatViewport(const Mat &src, Mat &dst, float radiusH, float radiusV,
+                      const Rect2f &roi, float scale, int interpolation) {
+    CV_Assert(!src.empty() && scale > 0.0f && roi.width > 0 && roi.height > 0);
+
+    const Size outSize(std::max(cvRound(roi.width * scale), 1), std::max(cvRound(roi.height * scale), 1));
+
+    // remap cannot run in place, and creating dst may free the pixels src still points at;
+    // a destination sharing memory with the source is written through a temporary instead.
+    const bool aliased = !dst.empty() && dst.datastart < src.dataend && src.datastart < dst.dataend;
+    Mat temp;
+    Mat &out = aliased ? temp : dst;
+    out.create(outSize, src.type());
+
+    // --- 1️⃣ Per-column / per-row source coordinates of the viewport
+    AutoBuffer<float> colBuf(outSize.width), rowBuf(outSize.height);
+    float *px = colBuf.data(), *py = rowBuf.data();
+    const float step = 1.0f / scale, offset = 0.5f * step - 0.5f;
+    viewportProfile(outSize.width, roi.x + offset, step, src.cols, radiusH, px);
+    viewportProfile(outSize.height, roi.y + offset, step, src.rows, radiusV, py);
+
+    // --- 2️⃣ Source ROI from the extent of the inverse mapping, plus kernel taps
+    const int margin = interpolation == INTER_CUBIC ? 2 : 1;
+    const auto xr = std::minmax_element(px, px + outSize.width);
+    const auto yr = std::minmax_element(py, py + outSize.height);
+    const Rect srcRoi = Rect(Point(cvFloor(*xr.first) - margin, cvFloor(*yr.first) - margin),
+                             Point(cvCeil(*xr.second) + margin + 1, cvCeil(*yr.second) + margin + 1)) &
+                        Rect(0, 0, src.cols, src.rows);
+    if (srcRoi.empty()) {
+        out.setTo(Scalar::all(0));
+        if (aliased) temp.copyTo(dst);
+        return srcRoi;
+    }
+
+    // --- 3️⃣ Screen-sized maps relative to the ROI, then one remap of the sub-Mat
+    Mat mapX(outSize, CV_32FC1), mapY(outSize, CV_32FC1);
+    parallel_for_(Range(0, outSize.height), [&](const Range &range) {
+        for (int v = range.start; v < range.end; ++v) {
+            float *mx = mapX.ptr<float>(v);
+            float *my = mapY.ptr<float>(v);
+            const float sy = py[v] - srcRoi.y;
+            for (int u = 0; u < outSize.width; ++u) {
+                mx[u] = px[u] - srcRoi.x;
+                my[u] = sy;
+            }
+        }
+    });
+
+    remap(src(srcRoi), out, mapX, mapY, interpolation, BORDER_CONSTANT, Scalar::all(0));
+    if (aliased) temp.copyTo(dst);
+    return srcRoi;
+}
+
+void distortFlattenMaps(const LensModel &lens, Mat &mapX, Mat &mapY) {
+    CV_Assert(lens.fx > 0 && lens.fy > 0);
+    CV_Assert(mapX.type() == CV_32FC1 && mapY.type() == CV_32FC1 && mapX.size() == mapY.size());
+
+    parallel_for_(Range(0, mapX.rows), [&](const Range &range) {
+        const float ifx = 1.f / lens.fx, ify = 1.f / lens.fy;
+        for (int y = range.start; y < range.end; ++y) {
+            float *mx = mapX.ptr<float>(y);
+            float *my = mapY.ptr<float>(y);
+            for (int x = 0; x < mapX.cols; ++x) {
+                const float u = (mx[x] - lens.cx) * ifx, v = (my[x] - lens.cy) * ify;
+                const float u2 = u * u, v2 = v * v, r2 = u2 + v2, uv = 2.f * u * v;
+                const float radial = 1.f + r2 * (lens.k1 + r2 * (lens.k2 + r2 * lens.k3));
+                const float du = u * radial + lens.p1 * uv + lens.p2 * (r2 + 2.f * u2);
+                const float dv = v * radial + lens.p1 * (r2 + 2.f * v2) + lens.p2 * uv;
+                mx[x] = lens.fx * du + lens.cx;
+                my[x] = lens.fy * dv + lens.cy;
+            }
+        }
+    });
+}
+
+/** Q14 weights of the CV_8UC4 fixed-point path: 1.0 is 1 << 14, so cubic lobes fit in int16. */
+static const int FIXED_BITS = 14;
+
+/**
+ * Fills the fixed-point entry of output pixel @p x. The window of taps
+ * consecutive source pixels starting at @p first is shifted to lie inside the
+ * row; taps that fall outside keep weight 0 (black border). Weights are
+ * rounded to Q14 with the rounding error moved onto the largest one, so a
+ * flat input stays exactly flat.
+ */
+static void setFixedPointTaps(RowResampleTable &table, int x, int first, const float *w) {
+    const int taps = table.taps;
+    const int start = std::min(std::max(first, 0), table.width - taps);
+    float window[4] = {0.f, 0.f, 0.f, 0.f};
+    float sum = 0.f;
+    for (int k = 0; k < taps; ++k) {
+        const int sx = first + k;
+        if (sx < 0 || sx >= table.width) continue;
+        window[sx - start] += w[k];
+        sum += w[k];
+    }
+
+    int q[4], total = 0, largest = 0;
+    for (int k = 0; k < taps; ++k) {
+        q[k] = cvRound(window[k] * (1 << FIXED_BITS));
+        total += q[k];
+        if (std::abs(q[k]) > std::abs(q[largest])) largest = k;
+    }
+    q[largest] += cvRound(sum * (1 << FIXED_BITS)) - total;
+
+    // Taps are stored in pairs interleaved per channel, (w0 w1) x 4 then (w2 w3) x 4,
+    // matching pixels interleaved by v_interleave_quads for v_dotprod.
+    table.pixelStarts[x] = start * 4;
+    short *dst = table.pixelWeights.data() + (size_t) x * taps * 4;
+    for (int k = 0; k < taps; ++k)
+        for (int c = 0; c < 4; ++c) dst[(k / 2) * 8 + 2 * c + (k & 1)] = (short) q[k];
+}
+
+void buildCylinderResampleTable(int width, int channels, float radius, int interpolation,
+                                RowResampleTable &table, bool inverse) {
+    CV_Assert(width > 0 && channels > 0 && radius > 0.0f);
+    CV_Assert(interpolation == INTER_LINEAR || interpolation == INTER_CUBIC);
+    TRACE_SCOPE("buildResampleTable");
+
+    const int taps = interpolation == INTER_CUBIC ? 4 : 2;
+    const int count = width * channels;
+    table.width = width;
+    table.channels = channels;
+    table.taps = taps;
+    table.offsets.assign((size_t) taps * count, 0);
+    table.weights.assign((size_t) taps * count, 0.f);
+    const bool fixedPoint = channels == 4 && width >= taps;
+    table.pixelStarts.assign(fixedPoint ? width : 0, 0);
+    table.pixelWeights.assign(fixedPoint ? (size_t) width * taps * 4 : 0, 0);
+
+    const float cx = width / 2.0f;
+    for (int x = 0; x < width; ++x) {
+        const float u = (x - cx) / radius;
+        if (inverse && std::fabs(u) > 1.f) continue; // outside the arc: all weights stay 0
+
+        const float srcX = radius * (inverse ? asinf(u) : sinf(u)) + cx;
+        const int i0 = cvFloor(srcX);
+        const float t = srcX - i0;
+
+        float w[4];
+        int first;
+        if (taps == 2) {
+            w[0] = 1.f - t;
+            w[1] = t;
+            first = i0;
+        } else {
+            const float A = -0.75f;
+            w[0] = ((A * (t + 1) - 5 * A) * (t + 1) + 8 * A) * (t + 1) - 4 * A;
+            w[1] = ((A + 2) * t - (A + 3)) * t * t + 1;
+            w[2] = ((A + 2) * (1 - t) - (A + 3)) * (1 - t) * (1 - t) + 1;
+            w[3] = 1.f - w[0] - w[1] - w[2];
+            first = i0 - 1;
+        }
+
+        for (int k = 0; k < taps; ++k) {
+            const int sx = first + k;
+            const bool inside = sx >= 0 && sx < width;
+            const int clamped = inside ? sx : 0;
+            for (int c = 0; c < channels; ++c) {
+                const size_t e = (size_t) k * count + x * channels + c;
+                table.offsets[e] = clamped * channels + c;
+                table.weights[e] = inside ? w[k] : 0.f;
+            }
+        }
+        if (fixedPoint) setFixedPointTaps(table, x, first, w);
+    }
+}
+
+namespace {
+
+/**
+ * Element-type policy of the row engine: widen a source row to float, and
+ * narrow 16 float results (four vectors) or one scalar back with rounding
+ * and saturation.
+ */
+template <typename T>
+struct RowIO;
+
+template <>
+struct RowIO<uchar> {
+    static void load(const uchar *s, float *d, int n) {
+        int j = 0;
+#if CV_SIMD128
+        for (; j <= n - 4; j += 4)
+            v_store(d + j, v_cvt_f32(v_reinterpret_as_s32(v_load_expand_q(s + j))));
+#endif
+        for (; j < n; ++j) d[j] = s[j];
+    }
+#if CV_SIMD128
+    static void store16(uchar *d, const v_float32x4 *acc) {
+        v_int16x8 lo = v_pack(v_round(acc[0]), v_round(acc[1]));
+        v_int16x8 hi = v_pack(v_round(acc[2]), v_round(acc[3]));
+        v_store(d, v_pack_u(lo, hi));
+    }
+#endif
+    static uchar cast(float v) { return saturate_cast<uchar>(v); }
+};
+
+template <>
+struct RowIO<ushort> {
+    static void load(const ushort *s, float *d, int n) {
+        int j = 0;
+#if CV_SIMD128
+        for (; j <= n - 8; j += 8) {
+            v_uint32x4 lo, hi;
+            v_expand(v_load(s + j), lo, hi);
+            v_store(d + j, v_cvt_f32(v_reinterpret_as_s32(lo)));
+            v_store(d + j + 4, v_cvt_f32(v_reinterpret_as_s32(hi)));
+        }
+#endif
+        for (; j < n; ++j) d[j] = s[j];
+    }
+#if CV_SIMD128
+    static void store16(ushort *d, const v_float32x4 *acc) {
+        v_store(d, v_pack_u(v_round(acc[0]), v_round(acc[1])));
+        v_store(d + 8, v_pack_u(v_round(acc[2]), v_round(acc[3])));
+    }
+#endif
+    static ushort cast(float v) { return saturate_cast<ushort>(v); }
+};
+
+template <>
+struct RowIO<float> {
+    static void load(const float *s, float *d, int n) { std::copy(s, s + n, d); }
+#if CV_SIMD128
+    static void store16(float *d, const v_float32x4 *acc) {
+        for (int q = 0; q < 4; ++q) v_store(d + 4 * q, acc[q]);
+    }
+#endif
+    static float cast(float v) { return v; }
+};
+
+#if CV_SIMD128
+/**
+ * Fetches the four source elements of one tap. With four channels the
+ * offsets of a pixel are consecutive, so one unaligned load replaces the
+ * gather; other channel counts gather element by element.
+ */
+template <int CN>
+inline v_float32x4 loadTap(const float *row, const int *off) {
+    return CN == 4 ? v_load(row + off[0]) : v_lut(row, off);
+}
+#endif
+
+/** Resamples one float source row into a destination row of type T with CN channels. */
+template <typename T, int CN>
+void resampleRow(const float *srcRow, T *dstRow, const RowResampleTable &table) {
+    const int count = table.width * table.channels;
+    const int taps = table.taps;
+    const int *off = table.offsets.data();
+    const float *wt = table.weights.data();
+    int j = 0;
+
+#if CV_SIMD128
+    for (; j <= count - 16; j += 16) {
+        v_float32x4 acc[4];
+        for (int q = 0; q < 4; ++q) {
+            const int e = j + 4 * q;
+            acc[q] = v_mul(loadTap<CN>(srcRow, off + e), v_load(wt + e));
+            for (int k = 1; k < taps; ++k) {
+                const size_t p = (size_t) k * count + e;
+                acc[q] = v_fma(loadTap<CN>(srcRow, off + p), v_load(wt + p), acc[q]);
+            }
+        }
+        RowIO<T>::store16(dstRow + j, acc);
+    }
+#endif
+
+    for (; j < count; ++j) {
+        float acc = 0.f;
+        for (int k = 0; k < taps; ++k) {
+            const size_t p = (size_t) k * count + j;
+            acc += srcRow[off[p]] * wt[p];
+        }
+        dstRow[j] = RowIO<T>::cast(acc);
+    }
+}
+
+/** Resamples rows [range) of src into dst through one float scratch row; src may equal dst. */
+template <typename T, int CN>
+void resampleRowRange(const Mat &src, Mat &dst, const RowResampleTable &table,
+                      const Range &range, float *rowF) {
+    const int count = table.width * table.channels;
+    for (int y = range.start; y < range.end; ++y) {
+        RowIO<T>::load(src.ptr<T>(y), rowF, count);
+        resampleRow<T, CN>(rowF, dst.ptr<T>(y), table);
+    }
+}
+
+/**
+ * Resamples one CV_8UC4 row with the table's fixed-point form. Each output
+ * pixel reads its TAPS source pixels with one contiguous load; interleaving
+ * neighbouring pixels per channel lets one multiply-add (pmaddwd / vmull +
+ * vpadd) apply two Q14 weights to all four channels at once.
+ */
+template <int TAPS>
+void resampleRowFixed8UC4(const uchar *src, uchar *dst, const RowResampleTable &table) {
+    const int width = table.width;
+    const int *start = table.pixelStarts.data();
+    const short *wt = table.pixelWeights.data();
+    int x = 0;
+
+#if CV_SIMD128
+    for (; x <= width - 4; x += 4) {
+        v_int32x4 acc[4];
+        if (TAPS == 2) {
+            // Two 2-pixel windows per load, one per 64-bit half.
+            for (int q = 0; q < 4; q += 2) {
+                v_uint16x8 p0, p1;
+                v_expand(v_interleave_quads(v_load_halves(src + start[x + q], src + start[x + q + 1])), p0, p1);
+                acc[q] = v_dotprod(v_reinterpret_as_s16(p0), v_load(wt + (size_t) (x + q) * 8));
+                acc[q + 1] = v_dotprod(v_reinterpret_as_s16(p1), v_load(wt + (size_t) (x + q + 1) * 8));
+            }
+        } else {
+            for (int q = 0; q < 4; ++q) {
+                const short *w = wt + (size_t) (x + q) * 16;
+                v_uint16x8 p01, p23;
+                v_expand(v_interleave_quads(v_load(src + start[x + q])), p01, p23);
+                acc[q] = v_dotprod(v_reinterpret_as_s16(p23), v_load(w + 8),
+                                   v_dotprod(v_reinterpret_as_s16(p01), v_load(w)));
+            }
+        }
+        v_store(dst + 4 * x, v_pack_u(v_rshr_pack<FIXED_BITS>(acc[0], acc[1]),
+                                      v_rshr_pack<FIXED_BITS>(acc[2], acc[3])));
+    }
+#endif
+
+    for (; x < width; ++x) {
+        const uchar *s = src + start[x];
+        const short *w = wt + (size_t) x * TAPS * 4;
+        for (int c = 0; c < 4; ++c) {
+            int acc = 1 << (FIXED_BITS - 1);
+            for (int k = 0; k < TAPS; ++k) acc += s[4 * k + c] * w[(k / 2) * 8 + 2 * c + (k & 1)];
+            dst[4 * x + c] = saturate_cast<uchar>(acc >> FIXED_BITS);
+        }
+    }
+}
+
+/**
+ * Fixed-point counterpart of resampleRowRange for CV_8UC4. Rows are read
+ * straight from src; only in place is each row first copied into the scratch
+ * buffer, used as bytes.
+ */
+template <int TAPS>
+void resampleRowRangeFixed(const Mat &src, Mat &dst, const RowResampleTable &table,
+                           const Range &range, float *scratch) {
+    const int bytes = table.width * 4;
+    uchar *copy = reinterpret_cast<uchar *>(scratch);
+    for (int y = range.start; y < range.end; ++y) {
+        const uchar *s = src.ptr<uchar>(y);
+        if (src.data == dst.data) {
+            std::copy(s, s + bytes, copy);
+            s = copy;
+        }
+        resampleRowFixed8UC4<TAPS>(s, dst.ptr<uchar>(y), table);
+    }
+}
+
+typedef void (*RowRangeFunc)(const Mat &, Mat &, const RowResampleTable &, const Range &, float *);
+
+template <typename T>
+RowRangeFunc rowRangeFor(int channels) {
+    // Only the 4-channel layout changes the inner loop; 1 and 3 channels share the gather path.
+    return channels == 4 ? resampleRowRange<T, 4> : resampleRowRange<T, 1>;
+}
+
+RowRangeFunc selectRowRange(const Mat &src, const RowResampleTable &table) {
+    CV_Assert(src.cols == table.width && src.channels() == table.channels);
+    switch (src.depth()) {
+        case CV_8U:
+            if (table.channels == 4 && !table.pixelStarts.empty())
+                return table.taps == 4 ? resampleRowRangeFixed<4> : resampleRowRangeFixed<2>;
+            return rowRangeFor<uchar>(table.channels);
+        case CV_16U: return rowRangeFor<ushort>(table.channels);
+        case CV_32F: return rowRangeFor<float>(table.channels);
+        default:
+            CV_Error(Error::StsUnsupportedFormat, "Row resampler supports CV_8U, CV_16U and CV_32F");
+    }
+}
+
+} // namespace
+
+bool isRowResampleSupported(int depth) {
+    return depth == CV_8U || depth == CV_16U || depth == CV_32F;
+}
+
+void resampleRows(const Mat &src, Mat &dst, const RowResampleTable &table) {
+    const RowRangeFunc func = selectRowRange(src, table);
+
+    dst.create(src.size(), src.type());
+    CV_Assert(src.data != dst.data);
+    const int count = table.width * table.channels;
+
+    TRACE_SCOPE("resampleRows");
+    parallel_for_(Range(0, src.rows), [&](const Range &range) {
+        TRACE_SCOPE("resampleBand");
+        AutoBuffer<float> rowBuf(count);
+        func(src, dst, table, range, rowBuf.data());
+    });
+}
+
+void resampleRowsInPlace(Mat &mat, const RowResampleTable &table, bool bandParallel) {
+    const RowRangeFunc func = selectRowRange(mat, table);
+    const int count = table.width * table.channels;
+
+    TRACE_SCOPE("resampleRows");
+    if (!bandParallel) {
+        AutoBuffer<float> rowBuf(count);
+        func(mat, mat, table, Range(0, mat.rows), rowBuf.data());
+        return;
+    }
+
+    // Each band owns disjoint rows, so reading and writing the same Mat is safe.
+    parallel_for_(Range(0, mat.rows), [&](const Range &range) {
+        TRACE_SCOPE("resampleBand");
+        AutoBuffer<float> rowBuf(count);
+        func(mat, mat, table, range, rowBuf.data());
+    });
+}
+
+PredistortStream::PredistortStream(int width, int height, float radius, int interpolation) {
+    buildCylinderResampleTable(width, 4, radius, interpolation, table_, true);
+    buffers_[0].create(height, width, CV_8UC4);
+    buffers_[1].create(height, width, CV_8UC4);
+}
+
+size_t PredistortStream::bytes() const {
+    return 2 * buffers_[0].total() * buffers_[0].elemSize() +
+           table_.offsets.size() * sizeof(int) + table_.weights.size() * sizeof(float) +
+           table_.pixelStarts.size() * sizeof(int) + table_.pixelWeights.size() * sizeof(short);
+}
+
+int PredistortStream::process(const Mat &rgba) {
+    CV_Assert(rgba.type() == CV_8UC4 && rgba.size() == buffers_[0].size());
+
+    const int back = front_ ^ 1;
+    resampleRows(rgba, buffers_[back], table_); // same size and type: no reallocation
+    front_ = back;
+    return back;
+}
+
+FlattenMapCache &FlattenMapCache::instance() {
+    static FlattenMapCache cache;
+    return cache;
+}
+
+void FlattenMapCache::get(const FlattenMapKey &key, Mat &map1, Mat &map2) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->key == key) {
+                entries_.splice(entries_.begin(), entries_, it);
+                map1 = it->map1;
+                map2 = it->map2;
+                ++hits_;
+                return;
+            }
+        }
+        ++misses_;
+    }
+
+    // Build outside the lock; a concurrent miss on the same key just builds twice.
+    TRACE_SCOPE("buildFlattenMaps");
+    Mat mapX, mapY;
+    buildDomeFlattenMaps(Size(key.width, key.height), key.radiusH, key.radiusV, mapX, mapY);
+    if (key.lens.fx > 0) distortFlattenMaps(key.lens, mapX, mapY);
+    convertMaps(mapX, mapY, map1, map2, CV_16SC2, key.interpolation == INTER_NEAREST);
+
+    const size_t bytes = map1.total() * map1.elemSize() + map2.total() * map2.elemSize();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bytes > capacity_) return;
+    for (const Entry &e : entries_)
+        if (e.key == key) return;
+
+    evictToFit(bytes);
+    entries_.push_front(Entry{key, map1, map2, bytes});
+    bytes_ += bytes;
+}
+
+void FlattenMapCache::evictToFit(size_t incoming) {
+    while (!entries_.empty() && bytes_ + incoming > capacity_) {
+        bytes_ -= entries_.back().bytes;
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
+
+void FlattenMapCache::setCapacity(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = bytes;
+    evictToFit(0);
+}
+
+void FlattenMapCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    bytes_ = 0;
+}
+
+FlattenMapCacheStats FlattenMapCache::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {hits_, misses_, evictions_, (int64_t) entries_.size(),
+            (int64_t) bytes_, (int64_t) capacity_};
+}
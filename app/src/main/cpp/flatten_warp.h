@@ -0,0 +1,265 @@
+#ifndef FLATTEN_WARP_H
+#define FLATTEN_WARP_H
+
+#include <opencv2/core.hpp>
+#include <list>
+#include <mutex>
+#include <vector>
+
+/**
+ * Builds remap tables that flatten a wall curved about both axes (dome or
+ * barrel): mapX(x, y) = Rh·sin((x - cx)/Rh) + cx and
+ * mapY(x, y) = Rv·sin((y - cy)/Rv) + cy.
+ *
+ * A radius <= 0 leaves that axis undistorted, so (R, 0) reproduces the
+ * horizontal-only cylindrical warp. The sin profiles are computed once per
+ * column and per row with vectorized polarToCart; the full-size maps are then
+ * filled in parallel row bands.
+ *
+ * @param size    Image size.
+ * @param radiusH Horizontal radius in pixels.
+ * @param radiusV Vertical radius in pixels.
+ * @param mapX    Output CV_32FC1 map (reallocated only if size changes).
+ * @param mapY    Output CV_32FC1 map (reallocated only if size changes).
+ */
+void buildDomeFlattenMaps(cv::Size size, float radiusH, float radiusV,
+                          cv::Mat &mapX, cv::Mat &mapY);
+
+/**
+ * Renders only a viewport of the flattened image, at display resolution.
+ *
+ * Output pixel (u, v) shows flattened position
+ * (roi.x + (u + 0.5)/scale - 0.5, roi.y + (v + 0.5)/scale - 0.5). The dome
+ * warp is separable, so the source column of every output column and the
+ * source row of every output row are computed once; their extent gives the
+ * exact source region, and remap reads only that sub-Mat. Cost is
+ * proportional to the number of output pixels, not the frame size.
+ *
+ * @param src     Full curved frame (any type remap accepts).
+ * @param dst     Output, (re)allocated to round(roi.size · scale). May be
+ *                @p src itself; an aliased output goes through a temporary.
+ * @param radiusH Horizontal radius in pixels, <= 0 for none.
+ * @param radiusV Vertical radius in pixels, <= 0 for none.
+ * @param roi     Visible region in flattened full-resolution pixels.
+ * @param scale   Output pixels per flattened pixel.
+ * @return        Source region that was read (including interpolation taps),
+ *                clamped to @p src; empty if the viewport misses the frame.
+ */
+cv::Rect warpFlatViewport(const cv::Mat &src, cv::Mat &dst, float radiusH, float radiusV,
+                          const cv::Rect2f &roi, float scale, int interpolation);
+
+/**
+ * Gather table for a horizontal-only warp, where every row uses the same
+ * source columns. Built once per (width, channels, radius, kernel) and applied
+ * row by row, so no full-size map is ever allocated.
+ *
+ * Entries are per output element (pixel·channel) so a row can be resampled
+ * with plain SIMD gathers regardless of the channel count. Taps falling
+ * outside the row get weight 0 (BORDER_CONSTANT with black).
+ *
+ * Weights are exact floats, whereas remap quantizes source positions to
+ * 1/32 px, so the two paths are close but not identical at any depth: the
+ * difference grows with the local gradient (8-bit frames differ by 1 on
+ * smooth content and by up to 6 on pixel-level noise). RowResamplerTest
+ * holds smooth 8-bit RGBA to 1 level when flattening and 3 when
+ * pre-distorting.
+ *
+ * Four-channel tables also carry a fixed-point form for CV_8UC4 rows: per
+ * output pixel, a window of taps consecutive source pixels that stays inside
+ * the row, and Q14 weights repeated for each channel. Pixels are then read
+ * with one contiguous load instead of a gather, and there is no float row.
+ */
+struct RowResampleTable {
+    int width = 0;              // pixels per row
+    int channels = 0;
+    int taps = 0;               // 2 for INTER_LINEAR, 4 for INTER_CUBIC
+    std::vector<int> offsets;   // taps planes of width·channels source element offsets
+    std::vector<float> weights; // taps planes of width·channels weights
+    std::vector<int> pixelStarts;     // byte offset of each output pixel's window (4 channels only)
+    std::vector<short> pixelWeights;  // width · taps · 4 Q14 weights, tap pairs interleaved per channel
+};
+
+/**
+ * Builds the gather table for the cylindrical flatten
+ * srcX = R·sin((x - cx)/R) + cx with cx = width / 2.
+ *
+ * With @p inverse the table pre-distorts flat content for a curved wall
+ * instead: srcX = R·asin((x - cx)/R) + cx, and output columns beyond
+ * |x - cx| > R are black.
+ *
+ * @param interpolation INTER_LINEAR or INTER_CUBIC (Keys, a = -0.75, as remap).
+ */
+void buildCylinderResampleTable(int width, int channels, float radius, int interpolation,
+                                RowResampleTable &table, bool inverse = false);
+
+/** True for the depths the row resampler handles: CV_8U, CV_16U and CV_32F. */
+bool isRowResampleSupported(int depth);
+
+/**
+ * Applies @p table to every row of a CV_8U, CV_16U or CV_32F image, src -> dst.
+ *
+ * Each worker widens one source row to float, gathers taps with universal
+ * intrinsics and narrows back to the source type with rounding and
+ * saturation (float rows are stored as is). Kernels are instantiated per
+ * element type, with a 4-channel specialization that loads whole pixels
+ * instead of gathering. CV_8UC4 rows skip the float row entirely and use the
+ * table's fixed-point form: 16-bit products summed in 32 bits, one rounding
+ * shift. Rows are split across parallel_for_ bands; extra memory is one
+ * float row per band.
+ * @p dst is (re)allocated to src's size and type and must not alias @p src
+ * (use resampleRowsInPlace for that).
+ */
+void resampleRows(const cv::Mat &src, cv::Mat &dst, const RowResampleTable &table);
+
+/**
+ * In-place variant of resampleRows: no full-frame copy is made.
+ *
+ * The warp only moves pixels within a row, so each row is copied into a
+ * float scratch row and written back to the same row. With @p bandParallel
+ * the rows are split into parallel_for_ bands with one scratch row per band;
+ * otherwise a single scratch row is reused on the calling thread. Peak extra
+ * memory is O(width) either way.
+ */
+void resampleRowsInPlace(cv::Mat &mat, const RowResampleTable &table, bool bandParallel = true);
+
+/**
+ * Double-buffered pre-distortion of a stream of RGBA frames (flat -> curved).
+ *
+ * The gather table and both output frames are allocated once in the
+ * constructor; process() then warps each input into the back buffer and
+ * flips it to the front, so the consumer can upload or encode one frame while
+ * the next is being produced. Frames take the fixed-point CV_8UC4 path of
+ * resampleRows, split across parallel_for_ bands. Not thread-safe: drive it
+ * from one thread.
+ */
+class PredistortStream {
+public:
+    PredistortStream(int width, int height, float radius, int interpolation);
+
+    /**
+     * Warps @p rgba (width x height, CV_8UC4) into the back buffer and makes
+     * it the front one.
+     * @return Index (0 or 1) of the buffer now holding the result. It stays
+     *         untouched until the next-but-one call.
+     */
+    int process(const cv::Mat &rgba);
+
+    cv::Mat &buffer(int index) { return buffers_[index & 1]; }
+    int width() const { return table_.width; }
+    int height() const { return buffers_[0].rows; }
+
+    /** Bytes held: both output frames and the gather table. */
+    size_t bytes() const;
+
+private:
+    RowResampleTable table_;
+    cv::Mat buffers_[2];
+    int front_ = 1;
+};
+
+/**
+ * Pinhole intrinsics and distortion coefficients (k1, k2, p1, p2, k3) as
+ * produced by calibrateCamera. fx == 0 means no lens correction.
+ */
+struct LensModel {
+    float fx, fy, cx, cy;
+    float k1, k2, p1, p2, k3;
+
+    bool operator==(const LensModel &o) const {
+        return fx == o.fx && fy == o.fy && cx == o.cx && cy == o.cy && k1 == o.k1 &&
+               k2 == o.k2 && p1 == o.p1 && p2 == o.p2 && k3 == o.k3;
+    }
+};
+
+/**
+ * Composes lens undistortion into flatten maps in place.
+ *
+ * Every entry of @p mapX / @p mapY is a position in the undistorted image
+ * (new camera matrix = camera matrix, R = I, as in undistort()); it is
+ * replaced by the distorted source pixel initUndistortRectifyMap would fetch
+ * for it. A single remap with the result then undistorts and flattens in one
+ * pass.
+ */
+void distortFlattenMaps(const LensModel &lens, cv::Mat &mapX, cv::Mat &mapY);
+
+/**
+ * Identifies one set of flatten maps. Interpolation and border mode are part
+ * of the key because they decide the fixed-point conversion and are what the
+ * caller will pass to remap.
+ */
+struct FlattenMapKey {
+    int width;
+    int height;
+    float radiusH;
+    float radiusV; // 0 for the horizontal-only cylindrical warp
+    int interpolation;
+    int borderMode;
+    LensModel lens;  // all zero for no undistortion
+
+    FlattenMapKey(int width, int height, float radiusH, float radiusV, int interpolation,
+                  int borderMode, const LensModel &lens = LensModel())
+            : width(width), height(height), radiusH(radiusH), radiusV(radiusV),
+              interpolation(interpolation), borderMode(borderMode), lens(lens) {}
+
+    bool operator==(const FlattenMapKey &o) const {
+        return width == o.width && height == o.height && radiusH == o.radiusH &&
+               radiusV == o.radiusV && interpolation == o.interpolation &&
+               borderMode == o.borderMode && lens == o.lens;
+    }
+};
+
+/** Counters reported by FlattenMapCache::stats(). */
+struct FlattenMapCacheStats {
+    int64_t hits;
+    int64_t misses;
+    int64_t evictions;
+    int64_t entries;
+    int64_t bytes;
+    int64_t capacityBytes;
+};
+
+/**
+ * Process-wide LRU cache of flatten maps, so repeated warps of same-sized
+ * frames with an unchanged radius go straight to remap.
+ *
+ * Maps are stored after convertMaps to CV_16SC2 + CV_16UC1 fixed point
+ * (6 bytes/pixel instead of 8, and the faster remap path). Total size is
+ * bounded by a byte budget; least recently used entries are evicted first and
+ * a map larger than the whole budget is built but not retained. Returned Mats
+ * share the cached buffers and stay valid after eviction. Thread-safe.
+ */
+class FlattenMapCache {
+public:
+    static FlattenMapCache &instance();
+
+    /**
+     * Returns remap-ready maps for @p key, building them on a miss.
+     * For INTER_NEAREST @p map2 is empty.
+     */
+    void get(const FlattenMapKey &key, cv::Mat &map1, cv::Mat &map2);
+
+    void setCapacity(size_t bytes);
+    void clear();
+    FlattenMapCacheStats stats();
+
+private:
+    struct Entry {
+        FlattenMapKey key;
+        cv::Mat map1;
+        cv::Mat map2;
+        size_t bytes;
+    };
+
+    FlattenMapCache() = default;
+    void evictToFit(size_t incoming);
+
+    std::mutex mutex_;
+    std::list<Entry> entries_; // most recently used first
+    size_t bytes_ = 0;
+    size_t capacity_ = 96u << 20;
+    int64_t hits_ = 0;
+    int64_t misses_ = 0;
+    int64_t evictions_ = 0;
+};
+
+#endif // FLATTEN_WARP_H
@@ -0,0 +1,169 @@
+#include "jni_bindings.h"
+#include "bitmap_pool.h"
+#include "mat_allocator.h"
+#include "native_benchmarks.h"
+#include "stage_timer.h"
+
+#include <android/log.h>
+
+#define LOG_TAG "ChessboardJni"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static BitmapJni gBitmap = {nullptr, nullptr, nullptr};
+static int64_t gRegisterNativesNs = 0;
+
+const BitmapJni &bitmapJni() {
+    return gBitmap;
+}
+
+jobject newArgbBitmap(JNIEnv *env, int width, int height) {
+    return env->CallStaticObjectMethod(gBitmap.bitmapClass, gBitmap.createBitmap,
+                                       width, height, gBitmap.argb8888);
+}
+
+/**
+ * Resolves the Bitmap class, createBitmap and ARGB_8888 once and promotes
+ * them to global refs. Local refs are dropped right away.
+ */
+static bool initBitmapJni(JNIEnv *env) {
+    jclass bitmapCls = env->FindClass("android/graphics/Bitmap");
+    jclass configCls = env->FindClass("android/graphics/Bitmap$Config");
+    if (bitmapCls == nullptr || configCls == nullptr) return false;
+
+    gBitmap.createBitmap = env->GetStaticMethodID(
+            bitmapCls, "createBitmap",
+            "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;");
+    jfieldID argbFid = env->GetStaticFieldID(configCls, "ARGB_8888", "Landroid/graphics/Bitmap$Config;");
+    if (gBitmap.createBitmap == nullptr || argbFid == nullptr) return false;
+
+    jobject argb = env->GetStaticObjectField(configCls, argbFid);
+    gBitmap.bitmapClass = (jclass) env->NewGlobalRef(bitmapCls);
+    gBitmap.argb8888 = env->NewGlobalRef(argb);
+
+    env->DeleteLocalRef(argb);
+    env->DeleteLocalRef(configCls);
+    env->DeleteLocalRef(bitmapCls);
+    return gBitmap.bitmapClass != nullptr && gBitmap.argb8888 != nullptr;
+}
+
+/** Every ChessBoardManager native, bound explicitly instead of by symbol lookup. */
+static const JNINativeMethod kChessBoardManagerMethods[] = {
+    {"generateChessBoard", "(IIIIII)Landroid/graphics/Bitmap;", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoard},
+    {"generateChessBoardGroup", "(IIIIIII)Landroid/graphics/Bitmap;", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroup},
+    {"generateChessBoardGroupWithBlackPad", "(IIIIIIIIIIII)Landroid/graphics/Bitmap;", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackPad},
+    {"generateChessBoardInto", "(Landroid/graphics/Bitmap;IIIIII)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardInto},
+    {"generateChessBoardGroupInto", "(Landroid/graphics/Bitmap;IIIIIII)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupInto},
+    {"generateChessBoardGroupWithBlackPadInto", "(Landroid/graphics/Bitmap;IIIIIIIIIIII)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackPadInto},
+    {"acquirePooledBitmap", "(II)Landroid/graphics/Bitmap;", (void *) Java_com_kuro_android_opencv_ChessBoardManager_acquirePooledBitmap},
+    {"recyclePooledBitmap", "(Landroid/graphics/Bitmap;)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_recyclePooledBitmap},
+    {"getBitmapPoolStats", "()[J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_getBitmapPoolStats},
+    {"setBitmapPoolCapacity", "(J)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_setBitmapPoolCapacity},
+    {"clearBitmapPool", "()V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_clearBitmapPool},
+    {"detectCurvatureFromMat", "(JIIZII[J)F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureFromMat},
+    {"detectCurvatureIntoArray", "(JII[FIZII)F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureIntoArray},
+    {"detectCurvatureIntoBuffer", "(JIILjava/nio/ByteBuffer;ZII)F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureIntoBuffer},
+    {"detectCylinderFromMat", "(JII[FZI)F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_detectCylinderFromMat},
+    {"detectSegmentedCurvature", "(JII[I[FFI)I", (void *) Java_com_kuro_android_opencv_ChessBoardManager_detectSegmentedCurvature},
+    {"detectSurfaceCurvature", "(JII[FI)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_detectSurfaceCurvature},
+    {"pixelRadiusToMeters", "(FF)F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_pixelRadiusToMeters},
+    {"generateCurvatureProfile", "(IF)[F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfile},
+    {"generateCurvatureProfileIntoArray", "(IF[FI)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoArray},
+    {"generateCurvatureProfileIntoByteBuffer", "(IFLjava/nio/ByteBuffer;)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoByteBuffer},
+    {"generateCurvatureProfileIntoFloatBuffer", "(IFLjava/nio/FloatBuffer;)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoFloatBuffer},
+    {"generateCurvatureMapHandle", "(IIF)J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureMapHandle},
+    {"createCurvatureProfile", "(IIF)J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_createCurvatureProfile},
+    {"curvatureProfileRow", "(J)[F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_curvatureProfileRow},
+    {"curvatureProfileDense", "(J)J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_curvatureProfileDense},
+    {"releaseCurvatureProfile", "(J)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_releaseCurvatureProfile},
+    {"warpCurvedToFlat", "(JF)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlat},
+    {"warpCurvedToFlatInPlace", "(JFIZ)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlatInPlace},
+    {"warpDomeToFlatInPlace", "(JFF)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_warpDomeToFlatInPlace},
+    {"warpFlatToCurvedInPlace", "(JFIZ)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_warpFlatToCurvedInPlace},
+    {"warpUndistortFlatInPlace", "(JFF[F[FI)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_warpUndistortFlatInPlace},
+    {"warpFlatViewport", "(JJFFFFFFFI[I)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_warpFlatViewport},
+    {"getWarpCacheStats", "()[J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_getWarpCacheStats},
+    {"setWarpCacheCapacity", "(J)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_setWarpCacheCapacity},
+    {"clearWarpCache", "()V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_clearWarpCache},
+    {"createPredistortStream", "(IIFI)J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_createPredistortStream},
+    {"predistortStreamBuffer", "(JI)Ljava/nio/ByteBuffer;", (void *) Java_com_kuro_android_opencv_ChessBoardManager_predistortStreamBuffer},
+    {"predistortFrame", "(JLjava/nio/ByteBuffer;)I", (void *) Java_com_kuro_android_opencv_ChessBoardManager_predistortFrame},
+    {"releasePredistortStream", "(J)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_releasePredistortStream},
+    {"createMeshWarp", "(IIIIII)J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_createMeshWarp},
+    {"updateMeshWarp", "(JJI)I", (void *) Java_com_kuro_android_opencv_ChessBoardManager_updateMeshWarp},
+    {"applyMeshWarp", "(JJI)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_applyMeshWarp},
+    {"releaseMeshWarp", "(J)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_releaseMeshWarp},
+    {"createCalibrationSession", "(II)J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_createCalibrationSession},
+    {"calibrationSessionDetect", "(JJ[FIII)F", (void *) Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionDetect},
+    {"calibrationSessionWarp", "(JJFIZZ)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionWarp},
+    {"calibrationSessionPatternInto", "(JLandroid/graphics/Bitmap;IIIIIIIIIIII)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionPatternInto},
+    {"calibrationSessionStats", "(J)[J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionStats},
+    {"releaseCalibrationSession", "(J)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_releaseCalibrationSession},
+    {"nativeMatAddr", "(J)J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_nativeMatAddr},
+    {"releaseNative", "(J)Z", (void *) Java_com_kuro_android_opencv_ChessBoardManager_releaseNative},
+    {"getNativeHandleStats", "()[J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_getNativeHandleStats},
+    {"getNativeBytesHeld", "()J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_getNativeBytesHeld},
+    {"getMemoryStats", "()[J", (void *) Java_com_kuro_android_opencv_ChessBoardManager_getMemoryStats},
+    {"resetMemoryPeaks", "()V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_resetMemoryPeaks},
+    {"setMatPoolCapacity", "(J)V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_setMatPoolCapacity},
+    {"startNativeTrace", "()V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_startNativeTrace},
+    {"stopNativeTrace", "()V", (void *) Java_com_kuro_android_opencv_ChessBoardManager_stopNativeTrace},
+    {"writeNativeTrace", "(Ljava/lang/String;)I", (void *) Java_com_kuro_android_opencv_ChessBoardManager_writeNativeTrace},
+};
+
+static const jint kChessBoardManagerMethodCount =
+        sizeof(kChessBoardManagerMethods) / sizeof(kChessBoardManagerMethods[0]);
+
+const JNINativeMethod *chessBoardManagerMethods(jint *count) {
+    *count = kChessBoardManagerMethodCount;
+    return kChessBoardManagerMethods;
+}
+
+int64_t registerNativesNs() {
+    return gRegisterNativesNs;
+}
+
+static bool registerChessBoardManager(JNIEnv *env) {
+    jclass cls = env->FindClass("com/kuro/android/opencv/ChessBoardManager");
+    if (cls == nullptr) return false;
+    const jint rc = env->RegisterNatives(cls, kChessBoardManagerMethods, kChessBoardManagerMethodCount);
+    env->DeleteLocalRef(cls);
+    return rc == JNI_OK;
+}
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void * /*reserved*/) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) return JNI_ERR;
+
+    if (!initBitmapJni(env)) {
+        LOGE("Failed to resolve android.graphics.Bitmap");
+        return JNI_ERR;
+    }
+
+    // Mats allocated inside a MemoryStageScope are pooled and attributed to its
+    // stage; all others still go to OpenCV's standard allocator.
+    PooledMatAllocator::install();
+
+    const int64_t t0 = monotonicNs();
+    if (!registerChessBoardManager(env)) {
+        LOGE("RegisterNatives failed for ChessBoardManager");
+        return JNI_ERR;
+    }
+    gRegisterNativesNs = monotonicNs() - t0;
+    LOGI("Registered ChessBoardManager natives in %lld us", (long long) (gRegisterNativesNs / 1000));
+
+#ifdef CHESSBOARD_NATIVE_BENCHMARKS
+    // Only the instrumentation APK ships NativeBenchmarks; skip it when absent.
+    if (registerNativeBenchmarks(env)) LOGI("Registered NativeBenchmarks natives");
+#endif
+    return JNI_VERSION_1_6;
+}
+
+JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *vm, void * /*reserved*/) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) return;
+    BitmapPool::instance().clear(env);
+    if (gBitmap.bitmapClass) env->DeleteGlobalRef(gBitmap.bitmapClass);
+    if (gBitmap.argb8888) env->DeleteGlobalRef(gBitmap.argb8888);
+    gBitmap = {nullptr, nullptr, nullptr};
+}
@@ -0,0 +1,98 @@
+#ifndef JNI_BINDINGS_H
+#define JNI_BINDINGS_H
+
+#include <jni.h>
+#include <cstdint>
+
+/**
+ * JNI references resolved once in JNI_OnLoad and kept as global refs, so the
+ * generators no longer look up Bitmap and Bitmap.Config on every call (and
+ * no longer leak the local refs those lookups created).
+ */
+struct BitmapJni {
+    jclass bitmapClass;        // android.graphics.Bitmap
+    jmethodID createBitmap;    // Bitmap.createBitmap(int, int, Bitmap.Config)
+    jobject argb8888;          // Bitmap.Config.ARGB_8888
+};
+
+/** Cached Bitmap references; valid after JNI_OnLoad. */
+const BitmapJni &bitmapJni();
+
+/** Creates a width x height ARGB_8888 Bitmap through the cached references. */
+jobject newArgbBitmap(JNIEnv *env, int width, int height);
+
+/** The ChessBoardManager RegisterNatives table; its length goes to @p count. */
+const JNINativeMethod *chessBoardManagerMethods(jint *count);
+
+/** Nanoseconds the ChessBoardManager RegisterNatives call took in JNI_OnLoad. */
+int64_t registerNativesNs();
+
+/*
+ * ChessBoardManager entry points, registered with RegisterNatives in
+ * JNI_OnLoad. Declared here so any mismatch with the definitions in
+ * chessboard.cpp is a compile error.
+ */
+extern "C" {
+JNIEXPORT jobject JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoard(JNIEnv *, jobject, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jobject JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroup(JNIEnv *, jobject, jint, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jobject JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackPad(JNIEnv *, jobject, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardInto(JNIEnv *, jobject, jobject, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupInto(JNIEnv *, jobject, jobject, jint, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateChessBoardGroupWithBlackPadInto(JNIEnv *, jobject, jobject, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jobject JNICALL Java_com_kuro_android_opencv_ChessBoardManager_acquirePooledBitmap(JNIEnv *, jobject, jint, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_recyclePooledBitmap(JNIEnv *, jobject, jobject);
+JNIEXPORT jlongArray JNICALL Java_com_kuro_android_opencv_ChessBoardManager_getBitmapPoolStats(JNIEnv *, jobject);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_setBitmapPoolCapacity(JNIEnv *, jobject, jlong);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_clearBitmapPool(JNIEnv *, jobject);
+JNIEXPORT jfloat JNICALL Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureFromMat(JNIEnv *, jobject, jlong, int, int, jboolean, jint, jint, jlongArray);
+JNIEXPORT jfloat JNICALL Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureIntoArray(JNIEnv *, jobject, jlong, jint, jint, jfloatArray, jint, jboolean, jint, jint);
+JNIEXPORT jfloat JNICALL Java_com_kuro_android_opencv_ChessBoardManager_detectCurvatureIntoBuffer(JNIEnv *, jobject, jlong, jint, jint, jobject, jboolean, jint, jint);
+JNIEXPORT jfloat JNICALL Java_com_kuro_android_opencv_ChessBoardManager_detectCylinderFromMat(JNIEnv *, jobject, jlong, jint, jint, jfloatArray, jboolean, jint);
+JNIEXPORT jint JNICALL Java_com_kuro_android_opencv_ChessBoardManager_detectSegmentedCurvature(JNIEnv *, jobject, jlong, jint, jint, jintArray, jfloatArray, jfloat, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_detectSurfaceCurvature(JNIEnv *, jobject, jlong, jint, jint, jfloatArray, jint);
+JNIEXPORT jfloat JNICALL Java_com_kuro_android_opencv_ChessBoardManager_pixelRadiusToMeters(JNIEnv *, jobject, jfloat, jfloat);
+JNIEXPORT jfloatArray JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfile(JNIEnv *, jobject, jint, jfloat);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoArray(JNIEnv *, jobject, jint, jfloat, jfloatArray, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoByteBuffer(JNIEnv *, jobject, jint, jfloat, jobject);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureProfileIntoFloatBuffer(JNIEnv *, jobject, jint, jfloat, jobject);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_generateCurvatureMapHandle(JNIEnv *, jobject, jint, jint, jfloat);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_createCurvatureProfile(JNIEnv *, jobject, jint, jint, jfloat);
+JNIEXPORT jfloatArray JNICALL Java_com_kuro_android_opencv_ChessBoardManager_curvatureProfileRow(JNIEnv *, jobject, jlong);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_curvatureProfileDense(JNIEnv *, jobject, jlong);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_releaseCurvatureProfile(JNIEnv *, jobject, jlong);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlat(JNIEnv *, jobject, jlong, jfloat);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_warpCurvedToFlatInPlace(JNIEnv *, jobject, jlong, jfloat, jint, jboolean);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_warpDomeToFlatInPlace(JNIEnv *, jobject, jlong, jfloat, jfloat);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_warpFlatToCurvedInPlace(JNIEnv *, jobject, jlong, jfloat, jint, jboolean);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_warpUndistortFlatInPlace(JNIEnv *, jobject, jlong, jfloat, jfloat, jfloatArray, jfloatArray, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_warpFlatViewport(JNIEnv *, jobject, jlong, jlong, jfloat, jfloat, jfloat, jfloat, jfloat, jfloat, jfloat, jint, jintArray);
+JNIEXPORT jlongArray JNICALL Java_com_kuro_android_opencv_ChessBoardManager_getWarpCacheStats(JNIEnv *, jobject);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_setWarpCacheCapacity(JNIEnv *, jobject, jlong);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_clearWarpCache(JNIEnv *, jobject);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_createPredistortStream(JNIEnv *, jobject, jint, jint, jfloat, jint);
+JNIEXPORT jobject JNICALL Java_com_kuro_android_opencv_ChessBoardManager_predistortStreamBuffer(JNIEnv *, jobject, jlong, jint);
+JNIEXPORT jint JNICALL Java_com_kuro_android_opencv_ChessBoardManager_predistortFrame(JNIEnv *, jobject, jlong, jobject);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_releasePredistortStream(JNIEnv *, jobject, jlong);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_createMeshWarp(JNIEnv *, jobject, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jint JNICALL Java_com_kuro_android_opencv_ChessBoardManager_updateMeshWarp(JNIEnv *, jobject, jlong, jlong, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_applyMeshWarp(JNIEnv *, jobject, jlong, jlong, jint);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_releaseMeshWarp(JNIEnv *, jobject, jlong);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_createCalibrationSession(JNIEnv *, jobject, jint, jint);
+JNIEXPORT jfloat JNICALL Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionDetect(JNIEnv *, jobject, jlong, jlong, jfloatArray, jint, jint, jint);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionWarp(JNIEnv *, jobject, jlong, jlong, jfloat, jint, jboolean, jboolean);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionPatternInto(JNIEnv *, jobject, jlong, jobject, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint, jint);
+JNIEXPORT jlongArray JNICALL Java_com_kuro_android_opencv_ChessBoardManager_calibrationSessionStats(JNIEnv *, jobject, jlong);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_releaseCalibrationSession(JNIEnv *, jobject, jlong);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_nativeMatAddr(JNIEnv *, jobject, jlong);
+JNIEXPORT jboolean JNICALL Java_com_kuro_android_opencv_ChessBoardManager_releaseNative(JNIEnv *, jobject, jlong);
+JNIEXPORT jlongArray JNICALL Java_com_kuro_android_opencv_ChessBoardManager_getNativeHandleStats(JNIEnv *, jobject);
+JNIEXPORT jlong JNICALL Java_com_kuro_android_opencv_ChessBoardManager_getNativeBytesHeld(JNIEnv *, jobject);
+JNIEXPORT jlongArray JNICALL Java_com_kuro_android_opencv_ChessBoardManager_getMemoryStats(JNIEnv *, jobject);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_resetMemoryPeaks(JNIEnv *, jobject);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_setMatPoolCapacity(JNIEnv *, jobject, jlong);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_startNativeTrace(JNIEnv *, jobject);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_ChessBoardManager_stopNativeTrace(JNIEnv *, jobject);
+JNIEXPORT jint JNICALL Java_com_kuro_android_opencv_ChessBoardManager_writeNativeTrace(JNIEnv *, jobject, jstring);
+}
+
+#endif // JNI_BINDINGS_H
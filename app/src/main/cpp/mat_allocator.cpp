@@ -0,0 +1,185 @@
+#include "mat_allocator.h"
+
+#include <opencv2/core/utils/allocator_stats.impl.hpp>
+
+using namespace cv;
+
+namespace {
+
+// Static storage: the atomics start zeroed before any Mat can be allocated.
+utils::AllocatorStatistics gStageStats[MEM_STAGE_COUNT];
+std::atomic<int64_t> gStageMallocs[MEM_STAGE_COUNT];
+
+// Stage of the innermost MemoryStageScope on this thread, kNoStage outside any.
+const int kNoStage = -1;
+thread_local int tCurrentStage = kNoStage;
+
+// Same value as CV_AUTOSTEP in core_c.h, which the C++ headers do not pull in.
+const size_t kAutoStep = 0x7fffffff;
+
+inline MemoryStage stageOf(const UMatData *u) {
+    return static_cast<MemoryStage>(reinterpret_cast<intptr_t>(u->userdata));
+}
+
+} // namespace
+
+MemoryStageScope::MemoryStageScope(MemoryStage stage) : previous_(tCurrentStage) {
+    tCurrentStage = stage;
+}
+
+MemoryStageScope::MemoryStageScope(int stage) : previous_(tCurrentStage) {
+    if (stage >= 0 && stage < MEM_STAGE_COUNT) tCurrentStage = stage;
+}
+
+MemoryStageScope::~MemoryStageScope() {
+    tCurrentStage = previous_;
+}
+
+int MemoryStageScope::current() {
+    return tCurrentStage;
+}
+
+void MemoryStageScope::enter(MemoryStage stage) {
+    tCurrentStage = stage;
+}
+
+PooledMatAllocator &PooledMatAllocator::instance() {
+    static PooledMatAllocator *allocator = new PooledMatAllocator();
+    return *allocator;
+}
+
+void PooledMatAllocator::install() {
+    Mat::setDefaultAllocator(&instance());
+}
+
+uchar *PooledMatAllocator::take(size_t size, bool &pooled) const {
+    pooled = false;
+    if (size >= kMinPooledBytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = free_.find(size);
+        if (it != free_.end() && !it->second.empty()) {
+            uchar *data = it->second.back();
+            it->second.pop_back();
+            pooledBytes_ -= size;
+            --pooledBuffers_;
+            pooled = true;
+            return data;
+        }
+    }
+    return static_cast<uchar *>(fastMalloc(size));
+}
+
+void PooledMatAllocator::give(uchar *data, size_t size) const {
+    if (size >= kMinPooledBytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size <= capacity_) {
+            trimLocked(capacity_ - size);
+            free_[size].push_back(data);
+            pooledBytes_ += size;
+            ++pooledBuffers_;
+            return;
+        }
+    }
+    fastFree(data);
+}
+
+void PooledMatAllocator::trimLocked(size_t budget) const {
+    for (auto it = free_.begin(); it != free_.end() && pooledBytes_ > budget; ++it) {
+        std::vector<uchar *> &list = it->second;
+        while (!list.empty() && pooledBytes_ > budget) {
+            fastFree(list.back());
+            list.pop_back();
+            pooledBytes_ -= it->first;
+            --pooledBuffers_;
+        }
+    }
+}
+
+UMatData *PooledMatAllocator::allocate(int dims, const int *sizes, int type, void *data0,
+                                       size_t *step, AccessFlag flags,
+                                       UMatUsageFlags usageFlags) const {
+    // Outside the pipeline: plain OpenCV allocation, freed by the std allocator too.
+    const int stage = tCurrentStage;
+    if (stage == kNoStage)
+        return Mat::getStdAllocator()->allocate(dims, sizes, type, data0, step, flags, usageFlags);
+
+    // Step computation as in OpenCV's StdMatAllocator.
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data0 && step[i] != kAutoStep) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    UMatData *u = new UMatData(this);
+    u->userdata = reinterpret_cast<void *>(static_cast<intptr_t>(stage));
+    u->size = total;
+    if (data0) {
+        u->data = u->origdata = static_cast<uchar *>(data0);
+        u->flags |= UMatData::USER_ALLOCATED;
+        return u;
+    }
+
+    bool pooled;
+    u->data = u->origdata = take(total, pooled);
+    gStageStats[stage].onAllocate(total);
+    if (!pooled) ++gStageMallocs[stage];
+    return u;
+}
+
+bool PooledMatAllocator::allocate(UMatData *u, AccessFlag /*accessFlags*/,
+                                  UMatUsageFlags /*usageFlags*/) const {
+    return u != nullptr;
+}
+
+void PooledMatAllocator::deallocate(UMatData *u) const {
+    if (!u) return;
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if (!(u->flags & UMatData::USER_ALLOCATED)) {
+        gStageStats[stageOf(u)].onFree(u->size);
+        give(u->origdata, u->size);
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+void PooledMatAllocator::stageStats(MemoryStageStats *stats) const {
+    for (int s = 0; s < MEM_STAGE_COUNT; ++s) {
+        const utils::AllocatorStatistics &st = gStageStats[s];
+        stats[s] = {(int64_t) st.getNumberOfAllocations(), gStageMallocs[s].load(),
+                    (int64_t) st.getCurrentUsage(), (int64_t) st.getPeakUsage(),
+                    (int64_t) st.getTotalUsage()};
+    }
+}
+
+void PooledMatAllocator::resetPeaks() {
+    for (auto &st : gStageStats) st.resetPeakUsage();
+}
+
+size_t PooledMatAllocator::pooledBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pooledBytes_;
+}
+
+size_t PooledMatAllocator::pooledBuffers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pooledBuffers_;
+}
+
+size_t PooledMatAllocator::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+void PooledMatAllocator::setCapacity(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = bytes;
+    trimLocked(capacity_);
+}
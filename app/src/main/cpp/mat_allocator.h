@@ -0,0 +1,132 @@
+#ifndef MAT_ALLOCATOR_H
+#define MAT_ALLOCATOR_H
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Pipeline stages that Mat allocations are attributed to. Values are
+ * mirrored by the MEM_STAGE_* constants in ChessBoardManager.kt.
+ */
+enum MemoryStage {
+    MEM_STAGE_OTHER = 0,    // pipeline work not attributed to a finer stage
+    MEM_STAGE_CONVERT = 1,  // color conversion
+    MEM_STAGE_DETECT = 2,   // findChessboardCorners
+    MEM_STAGE_REFINE = 3,   // sub-pixel refinement
+    MEM_STAGE_FIT = 4,      // row/column/surface fits
+    MEM_STAGE_WARP = 5,     // map build and remap
+    MEM_STAGE_PATTERN = 6,  // pattern generation
+    MEM_STAGE_COUNT
+};
+
+/** Per-stage figures reported by PooledMatAllocator::stageStats(). */
+struct MemoryStageStats {
+    int64_t allocations;  // Mat buffers handed out
+    int64_t mallocs;      // of which not served from the pool
+    int64_t currentBytes; // still alive
+    int64_t peakBytes;    // high-water mark of currentBytes
+    int64_t totalBytes;   // handed out since start
+};
+
+/**
+ * cv::MatAllocator that recycles frame-sized buffers of the pipeline and
+ * attributes each of them to the calling thread's MemoryStage.
+ *
+ * Only allocations made while the thread is inside a MemoryStageScope, i.e.
+ * during a pipeline entry point, are pooled and counted. Every other
+ * allocation (Mats created from Kotlin or by other libraries) is forwarded
+ * to OpenCV's standard allocator and never sees the pool. OpenCV's own
+ * parallel_for_ workers carry no scope, so what they allocate inside
+ * cvtColor, remap or the corner search is not counted either; our parallel
+ * bodies re-enter the caller's stage (see MemoryStageScope::current()).
+ *
+ * Buffers of at least kMinPooledBytes are returned to a free list keyed by
+ * their exact size instead of being freed, up to a byte budget, so the
+ * gray image, remap scratch and other per-frame Mats of a steady stream
+ * reuse the same memory. Smaller buffers go straight to fastMalloc/fastFree.
+ * Statistics per stage use cv::utils::AllocatorStatistics (current, peak,
+ * total bytes) plus a count of allocations the pool could not serve.
+ *
+ * install() sets it as cv::Mat's default; Mat::setDefaultAllocator is process
+ * wide, which is why scoping is per thread rather than by swapping the
+ * default around each call. The instance is never destroyed, since Mats may
+ * outlive the library. Thread-safe.
+ */
+class PooledMatAllocator : public cv::MatAllocator {
+public:
+    static const size_t kMinPooledBytes = 64u << 10;
+    /** Default idle budget: a 1080p RGBA frame and its gray copy. Raise it with setCapacity. */
+    static const size_t kDefaultCapacity = 16u << 20;
+
+    static PooledMatAllocator &instance();
+
+    /** Sets this allocator as cv::Mat's default; unscoped threads are unaffected. */
+    static void install();
+
+    cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const CV_OVERRIDE;
+    bool allocate(cv::UMatData *u, cv::AccessFlag accessFlags,
+                  cv::UMatUsageFlags usageFlags) const CV_OVERRIDE;
+    void deallocate(cv::UMatData *u) const CV_OVERRIDE;
+
+    /** Fills @p stats, which has MEM_STAGE_COUNT entries. */
+    void stageStats(MemoryStageStats *stats) const;
+    /** Sets every stage's peak to its current usage. */
+    void resetPeaks();
+
+    size_t pooledBytes() const;
+    size_t pooledBuffers() const;
+    size_t capacity() const;
+    /** Sets the pool budget, freeing idle buffers beyond it. */
+    void setCapacity(size_t bytes);
+
+private:
+    PooledMatAllocator() = default;
+
+    uchar *take(size_t size, bool &pooled) const;
+    void give(uchar *data, size_t size) const;
+    void trimLocked(size_t budget) const;
+
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<size_t, std::vector<uchar *>> free_;
+    mutable size_t pooledBytes_ = 0;
+    mutable size_t pooledBuffers_ = 0;
+    size_t capacity_ = kDefaultCapacity;
+};
+
+/**
+ * Routes Mat allocations on the current thread through the pool, attributed
+ * to @p stage, until the scope ends; scopes nest and restore the enclosing
+ * stage.
+ *
+ * parallel_for_ bodies run on worker threads that have no scope of their own.
+ * Capture current() before the loop and open a scope from it in the body to
+ * charge the workers' allocations to the caller's stage:
+ *
+ *     const int stage = MemoryStageScope::current();
+ *     parallel_for_(range, [&](const Range &r) { MemoryStageScope memStage(stage); ... });
+ */
+class MemoryStageScope {
+public:
+    explicit MemoryStageScope(MemoryStage stage);
+    /** Re-enters a stage captured with current(); a negative value opens no scope. */
+    explicit MemoryStageScope(int stage);
+    ~MemoryStageScope();
+
+    /** Stage of the calling thread, -1 outside any scope. */
+    static int current();
+
+    /** Switches to the next stage of a multi-stage function within the same scope. */
+    void enter(MemoryStage stage);
+
+    MemoryStageScope(const MemoryStageScope &) = delete;
+    MemoryStageScope &operator=(const MemoryStageScope &) = delete;
+
+private:
+    int previous_;
+};
+
+#endif // MAT_ALLOCATOR_H
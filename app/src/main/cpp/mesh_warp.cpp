@@ -0,0 +1,247 @@
+#include "mesh_warp.h"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "trace_spans.h"
+
+using namespace cv;
+
+namespace {
+
+/**
+ * Regular lattice matched to the detected grid: corner (c, r) ideally sits at
+ * centre + (c - ic)·stepU + (r - ir)·stepV. toLattice maps image points back
+ * to fractional (c, r) lattice coordinates.
+ */
+struct Lattice {
+    Point2d centre;
+    Point2d stepU, stepV;
+    double ic, ir;
+    Matx22d toLattice;
+
+    Point2d ideal(int c, int r) const {
+        return centre + stepU * (c - ic) + stepV * (r - ir);
+    }
+
+    Point2d coords(double x, double y) const {
+        const Vec2d q = toLattice * Vec2d(x - centre.x, y - centre.y);
+        return {q[0] + ic, q[1] + ir};
+    }
+};
+
+bool buildLattice(const Point2f *corners, int cols, int rows, Lattice &lat) {
+    Point2d centre(0, 0), dirU(0, 0), dirV(0, 0);
+    double lenU = 0, lenV = 0;
+
+    for (int r = 0; r < rows; ++r) {
+        const Point2f *row = corners + r * cols;
+        dirU += Point2d(row[cols - 1] - row[0]);
+        for (int c = 1; c < cols; ++c) lenU += norm(row[c] - row[c - 1]);
+    }
+    for (int c = 0; c < cols; ++c) {
+        dirV += Point2d(corners[(rows - 1) * cols + c] - corners[c]);
+        for (int r = 1; r < rows; ++r) lenV += norm(corners[r * cols + c] - corners[(r - 1) * cols + c]);
+    }
+    for (int i = 0; i < cols * rows; ++i) centre += Point2d(corners[i]);
+
+    const double nu = norm(dirU), nv = norm(dirV);
+    if (nu < 1e-6 || nv < 1e-6) return false;
+
+    // Mean arc-length spacing, so the flattened board keeps its unrolled size.
+    lat.stepU = dirU * (lenU / (rows * (cols - 1)) / nu);
+    lat.stepV = dirV * (lenV / (cols * (rows - 1)) / nv);
+    lat.centre = centre * (1.0 / (cols * rows));
+    lat.ic = (cols - 1) / 2.0;
+    lat.ir = (rows - 1) / 2.0;
+
+    const Matx22d basis(lat.stepU.x, lat.stepV.x,
+                        lat.stepU.y, lat.stepV.y);
+    const double det = basis(0, 0) * basis(1, 1) - basis(0, 1) * basis(1, 0);
+    if (std::fabs(det) < 1e-9) return false;
+    lat.toLattice = Matx22d(basis(1, 1), -basis(0, 1),
+                            -basis(1, 0), basis(0, 0)) * (1.0 / det);
+    return true;
+}
+
+/** Thin-plate radial basis r²·log r², written in terms of r². */
+inline double tpsKernel(double r2) {
+    return r2 > 0 ? r2 * std::log(r2) : 0.0;
+}
+
+/**
+ * Displacement field ideal -> detected, sampled at arbitrary image points.
+ * Thin-plate nodes use lattice coordinates, which keeps the system well
+ * conditioned regardless of the board's pixel size.
+ */
+class DisplacementField {
+public:
+    DisplacementField(const Point2f *corners, int cols, int rows, const Lattice &lat, int method)
+            : cols_(cols), rows_(rows), lat_(lat), method_(method),
+              disp_((size_t) cols * rows) {
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c)
+                disp_[r * cols + c] = Point2d(corners[r * cols + c]) - lat.ideal(c, r);
+        if (method_ == MESH_THIN_PLATE) solveThinPlate();
+    }
+
+    bool valid() const { return method_ != MESH_THIN_PLATE || !weights_.empty(); }
+
+    Point2d at(double x, double y) const {
+        const Point2d q = lat_.coords(x, y);
+        return method_ == MESH_THIN_PLATE ? thinPlate(q) : bilinear(q);
+    }
+
+private:
+    Point2d bilinear(const Point2d &q) const {
+        // Clamp the cell but not the fraction: outside the board the edge cells extrapolate linearly.
+        const int c0 = std::min(std::max(cvFloor(q.x), 0), cols_ - 2);
+        const int r0 = std::min(std::max(cvFloor(q.y), 0), rows_ - 2);
+        const double tx = q.x - c0, ty = q.y - r0;
+        const Point2d *d = &disp_[r0 * cols_ + c0];
+        const Point2d top = d[0] + (d[1] - d[0]) * tx;
+        const Point2d bottom = d[cols_] + (d[cols_ + 1] - d[cols_]) * tx;
+        return top + (bottom - top) * ty;
+    }
+
+    Point2d thinPlate(const Point2d &q) const {
+        const int n = cols_ * rows_;
+        const double *w = weights_.ptr<double>();
+        Point2d d(w[2 * n] + w[2 * (n + 1)] * q.x + w[2 * (n + 2)] * q.y,
+                  w[2 * n + 1] + w[2 * (n + 1) + 1] * q.x + w[2 * (n + 2) + 1] * q.y);
+        for (int k = 0; k < n; ++k) {
+            const double dx = q.x - (k % cols_), dy = q.y - (k / cols_);
+            const double u = tpsKernel(dx * dx + dy * dy);
+            d.x += w[2 * k] * u;
+            d.y += w[2 * k + 1] * u;
+        }
+        return d;
+    }
+
+    /** Solves [K P; Pᵀ 0]·[w; a] = [d; 0] for both displacement components at once. */
+    void solveThinPlate() {
+        const int n = cols_ * rows_;
+        Mat L(n + 3, n + 3, CV_64F, Scalar(0)), rhs(n + 3, 2, CV_64F, Scalar(0));
+        for (int i = 0; i < n; ++i) {
+            const double xi = i % cols_, yi = i / cols_;
+            for (int j = i + 1; j < n; ++j) {
+                const double dx = xi - (j % cols_), dy = yi - (j / cols_);
+                L.at<double>(i, j) = L.at<double>(j, i) = tpsKernel(dx * dx + dy * dy);
+            }
+            const double p[3] = {1.0, xi, yi};
+            for (int k = 0; k < 3; ++k) L.at<double>(i, n + k) = L.at<double>(n + k, i) = p[k];
+            rhs.at<double>(i, 0) = disp_[i].x;
+            rhs.at<double>(i, 1) = disp_[i].y;
+        }
+        if (!solve(L, rhs, weights_, DECOMP_LU)) weights_.release();
+    }
+
+    int cols_, rows_;
+    Lattice lat_;
+    int method_;
+    std::vector<Point2d> disp_;
+    Mat weights_; // (n + 3) x 2: kernel weights, then affine terms 1, x, y
+};
+
+} // namespace
+
+bool buildMeshFlattenMaps(const Point2f *corners, int cols, int rows, Size size,
+                          int method, int meshStep, Mat &map1, Mat &map2) {
+    if (corners == nullptr || cols < 2 || rows < 2 || size.area() <= 0) return false;
+    TRACE_SCOPE("buildMeshMaps");
+
+    Lattice lat;
+    if (!buildLattice(corners, cols, rows, lat)) return false;
+    const DisplacementField field(corners, cols, rows, lat, method);
+    if (!field.valid()) return false;
+
+    // --- 1️⃣ Coarse mesh: one displacement every meshStep pixels, covering the image
+    const int step = std::max(meshStep, 2);
+    const int meshCols = (size.width + step - 1) / step + 1;
+    const int meshRows = (size.height + step - 1) / step + 1;
+    Mat mesh(meshRows, meshCols, CV_32FC2);
+    parallel_for_(Range(0, meshRows), [&](const Range &range) {
+        for (int my = range.start; my < range.end; ++my) {
+            Vec2f *m = mesh.ptr<Vec2f>(my);
+            for (int mx = 0; mx < meshCols; ++mx) {
+                const Point2d d = field.at(mx * step, my * step);
+                m[mx] = Vec2f((float) d.x, (float) d.y);
+            }
+        }
+    });
+
+    // --- 2️⃣ Expand tile by tile straight into remap's fixed-point layout
+    map1.create(size, CV_16SC2);
+    map2.create(size, CV_16UC1);
+    const int tilesX = meshCols - 1;
+    parallel_for_(Range(0, tilesX * (meshRows - 1)), [&](const Range &range) {
+        const float inv = 1.0f / step;
+        for (int t = range.start; t < range.end; ++t) {
+            const int tx = t % tilesX, ty = t / tilesX;
+            const int x0 = tx * step, y0 = ty * step;
+            const int x1 = std::min(x0 + step, size.width), y1 = std::min(y0 + step, size.height);
+            const Vec2f d00 = mesh.at<Vec2f>(ty, tx), d10 = mesh.at<Vec2f>(ty, tx + 1);
+            const Vec2f d01 = mesh.at<Vec2f>(ty + 1, tx), d11 = mesh.at<Vec2f>(ty + 1, tx + 1);
+
+            for (int y = y0; y < y1; ++y) {
+                const float fy = (y - y0) * inv;
+                const Vec2f left = d00 + (d01 - d00) * fy;
+                const Vec2f right = d10 + (d11 - d10) * fy;
+                short *m1 = map1.ptr<short>(y);
+                ushort *m2 = map2.ptr<ushort>(y);
+                for (int x = x0; x < x1; ++x) {
+                    const Vec2f d = left + (right - left) * ((x - x0) * inv);
+                    // Same rounding and packing as convertMaps(..., CV_16SC2).
+                    const int ix = saturate_cast<int>((x + d[0]) * INTER_TAB_SIZE);
+                    const int iy = saturate_cast<int>((y + d[1]) * INTER_TAB_SIZE);
+                    m1[2 * x] = saturate_cast<short>(ix >> INTER_BITS);
+                    m1[2 * x + 1] = saturate_cast<short>(iy >> INTER_BITS);
+                    m2[x] = (ushort) ((iy & (INTER_TAB_SIZE - 1)) * INTER_TAB_SIZE +
+                                      (ix & (INTER_TAB_SIZE - 1)));
+                }
+            }
+        }
+    });
+    return true;
+}
+
+MeshWarp::MeshWarp(Size size, int cols, int rows, int method, int meshStep, float tolerancePx)
+        : size_(size), cols_(cols), rows_(rows), method_(method), meshStep_(meshStep),
+          tolerance_(tolerancePx) {}
+
+bool MeshWarp::update(const std::vector<Point2f> &corners) {
+    if ((int) corners.size() != cols_ * rows_) return false;
+
+    if (ready() && corners_.size() == corners.size()) {
+        float maxShift = 0.f;
+        for (size_t i = 0; i < corners.size(); ++i)
+            maxShift = std::max(maxShift, (float) norm(corners[i] - corners_[i]));
+        if (maxShift <= tolerance_) return false;
+    }
+
+    Mat map1, map2;
+    if (!buildMeshFlattenMaps(corners.data(), cols_, rows_, size_, method_, meshStep_, map1, map2))
+        return false;
+
+    map1_ = map1;
+    map2_ = map2;
+    corners_ = corners;
+    ++rebuilds_;
+    return true;
+}
+
+size_t MeshWarp::bytes() const {
+    return map1_.total() * map1_.elemSize() + map2_.total() * map2_.elemSize() +
+           scratch_.total() * scratch_.elemSize() + corners_.capacity() * sizeof(Point2f);
+}
+
+bool MeshWarp::apply(Mat &mat, int interpolation) {
+    if (!ready()) return false;
+    CV_Assert(mat.size() == size_);
+
+    mat.copyTo(scratch_); // allocated once, reused every frame
+    TRACE_SCOPE("remap");
+    remap(scratch_, mat, map1_, map2_, interpolation, BORDER_CONSTANT, Scalar::all(0));
+    return true;
+}
@@ -0,0 +1,73 @@
+#ifndef MESH_WARP_H
+#define MESH_WARP_H
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+/** How corner displacements are spread over the image. */
+enum MeshInterpolation {
+    MESH_BILINEAR = 0,   // piecewise bilinear over the corner lattice, linear extrapolation outside
+    MESH_THIN_PLATE = 1  // thin-plate spline through every corner, smooth everywhere
+};
+
+/**
+ * Builds fixed-point remap maps that flatten a wall using the detected corner
+ * grid itself instead of an analytic arc.
+ *
+ * Each corner is assigned an ideal position on a regular lattice with the
+ * board's mean orientation, its centroid and its mean arc-length spacing, so
+ * only the bending is removed. The displacement ideal -> detected is
+ * evaluated on a coarse mesh every @p meshStep pixels and then expanded to
+ * per-pixel maps one mesh cell (tile) at a time in parallel, writing the
+ * CV_16SC2 + CV_16UC1 layout remap uses directly.
+ *
+ * @param corners  Row-major corner array of size cols·rows.
+ * @param size     Image size.
+ * @param method   MESH_BILINEAR or MESH_THIN_PLATE.
+ * @param meshStep Coarse mesh spacing in pixels (tile size).
+ * @return         false if the grid is degenerate.
+ */
+bool buildMeshFlattenMaps(const cv::Point2f *corners, int cols, int rows, cv::Size size,
+                          int method, int meshStep, cv::Mat &map1, cv::Mat &map2);
+
+/**
+ * Corner-driven flatten warp that keeps its maps across frames.
+ *
+ * update() rebuilds the maps only when some corner moved by more than the
+ * tolerance since the last build, so a live preview pays for map
+ * construction only when the camera or wall actually moves. Not thread-safe.
+ */
+class MeshWarp {
+public:
+    MeshWarp(cv::Size size, int cols, int rows, int method, int meshStep = 16,
+             float tolerancePx = 0.25f);
+
+    /**
+     * Feeds the corners detected in the current frame.
+     * @return true if the maps were rebuilt.
+     */
+    bool update(const std::vector<cv::Point2f> &corners);
+
+    bool ready() const { return !map1_.empty(); }
+    int rebuilds() const { return rebuilds_; }
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+    cv::Size size() const { return size_; }
+
+    /** Bytes held: fixed-point maps, the scratch frame and the reference corners. */
+    size_t bytes() const;
+
+    /** Flattens @p mat in place (same size as the warp); returns false before the first update. */
+    bool apply(cv::Mat &mat, int interpolation);
+
+private:
+    cv::Size size_;
+    int cols_, rows_, method_, meshStep_;
+    float tolerance_;
+    std::vector<cv::Point2f> corners_; // corners the current maps were built from
+    cv::Mat map1_, map2_;
+    cv::Mat scratch_;                  // reused source copy for the in-place remap
+    int rebuilds_ = 0;
+};
+
+#endif // MESH_WARP_H
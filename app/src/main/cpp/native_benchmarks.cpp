@@ -0,0 +1,309 @@
+#include "native_benchmarks.h"
+#include "corner_refine.h"
+#include "flatten_warp.h"
+#include "jni_bindings.h"
+#include "mat_allocator.h"
+#include "stage_timer.h"
+#include "trace_spans.h"
+
+#include <opencv2/imgproc.hpp>
+#include <android/log.h>
+#include <cmath>
+#include <cstdio>
+#include <dlfcn.h>
+
+#define LOG_TAG "NativeBenchmarks"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/** Every NativeBenchmarks native except nativeDispatchProbeUnregistered. */
+static const JNINativeMethod kNativeBenchmarksMethods[] = {
+    {"benchmarkRefineEngines", "(IIIIFIJ)[F", (void *) Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkRefineEngines},
+    {"benchmarkPredistortStream", "(IIFII)[F", (void *) Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkPredistortStream},
+    {"benchmarkRowResampler", "(IIFIZI)[F", (void *) Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkRowResampler},
+    {"benchmarkJniBinding", "(I)[F", (void *) Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkJniBinding},
+    {"nativeDispatchProbe", "()V", (void *) Java_com_kuro_android_opencv_NativeBenchmarks_nativeDispatchProbe},
+};
+
+bool registerNativeBenchmarks(JNIEnv *env) {
+    jclass cls = env->FindClass("com/kuro/android/opencv/NativeBenchmarks");
+    if (cls == nullptr) {
+        env->ExceptionClear();
+        return false;
+    }
+    const jint rc = env->RegisterNatives(cls, kNativeBenchmarksMethods,
+                                         sizeof(kNativeBenchmarksMethods) / sizeof(kNativeBenchmarksMethods[0]));
+    env->DeleteLocalRef(cls);
+    if (rc != JNI_OK) {
+        env->ExceptionClear();
+        LOGE("RegisterNatives failed for NativeBenchmarks");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Benchmarks the sub-pixel refinement engines on a synthetic chessboard with
+ * known ground-truth corners (see benchmarkRefineEngines in corner_refine.h).
+ *
+ * @param width      Synthetic image width in pixels.
+ * @param height     Synthetic image height in pixels.
+ * @param cols       Number of inner corners horizontally.
+ * @param rows       Number of inner corners vertically.
+ * @param noiseSigma Gaussian noise added to the rendered board (gray levels).
+ * @param iterations Timed runs averaged per engine.
+ * @param seed       RNG seed for board placement, noise and corner perturbation.
+ * @return           float[5]: initial RMS, cornerSubPix RMS, cornerSubPix ms,
+ *                   saddle RMS, saddle ms. RMS values are in pixels.
+ */
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkRefineEngines(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jint width,
+        jint height,
+        jint cols,
+        jint rows,
+        jfloat noiseSigma,
+        jint iterations,
+        jlong seed
+) {
+    TRACE_FUNCTION("benchmarkRefineEngines");
+    RefineBenchmark bench = benchmarkRefineEngines(width, height, cols, rows,
+                                                   noiseSigma, iterations, (uint64_t) seed);
+    LOGI("Refine benchmark: initial %.3f px | subpix %.3f px %.2f ms | saddle %.3f px %.2f ms",
+         bench.initialRms, bench.subPixRms, bench.subPixMs, bench.saddleRms, bench.saddleMs);
+
+    const jfloat values[] = {bench.initialRms, bench.subPixRms, bench.subPixMs,
+                             bench.saddleRms, bench.saddleMs};
+    jfloatArray jResult = env->NewFloatArray(5);
+    env->SetFloatArrayRegion(jResult, 0, 5, values);
+    return jResult;
+}
+
+/**
+ * Measures PredistortStream throughput on this device: a random RGBA frame of
+ * the given size is pre-distorted @p frames times after one warm-up frame.
+ *
+ * @return [msPerFrame, framesPerSecond, threads], or null on invalid arguments.
+ */
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkPredistortStream(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jint width,
+        jint height,
+        jfloat radiusPx,
+        jint interpolation,
+        jint frames
+) {
+    TRACE_FUNCTION("benchmarkPredistortStream");
+    if (width <= 0 || height <= 0 || radiusPx <= 0.0f || frames <= 0) return nullptr;
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+    PredistortStream stream(width, height, radiusPx, interpolation);
+    cv::Mat frame(height, width, CV_8UC4);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+    stream.process(frame);
+
+    const int64_t t0 = monotonicNs();
+    for (int i = 0; i < frames; ++i) stream.process(frame);
+    const double msPerFrame = (monotonicNs() - t0) / 1e6 / frames;
+
+    const jfloat values[] = {(jfloat) msPerFrame, (jfloat) (1000.0 / msPerFrame),
+                             (jfloat) cv::getNumThreads()};
+    jfloatArray result = env->NewFloatArray(3);
+    env->SetFloatArrayRegion(result, 0, 3, values);
+    return result;
+}
+
+/**
+ * Row resampler against the remap it replaced, on the same smooth RGBA frame:
+ * resampleRows with a cylinder gather table versus remap with the equivalent
+ * maps converted to CV_16SC2 once up front, as FlattenMapCache serves them.
+ * Table and map construction are not timed.
+ *
+ * @param inverse    Pre-distortion (flat -> curved) instead of flattening.
+ * @param iterations Timed runs per path, after one warm-up run each.
+ * @return [rowMs, remapMs, speedup, maxAbsDiff], or null on invalid arguments.
+ *         maxAbsDiff is in gray levels over every pixel and channel.
+ */
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkRowResampler(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jint width,
+        jint height,
+        jfloat radiusPx,
+        jint interpolation,
+        jboolean inverse,
+        jint iterations
+) {
+    TRACE_FUNCTION("benchmarkRowResampler");
+    if (width <= 0 || height <= 0 || radiusPx <= 0.0f || iterations <= 0) return nullptr;
+    if (interpolation != cv::INTER_CUBIC) interpolation = cv::INTER_LINEAR;
+
+    MemoryStageScope memStage(MEM_STAGE_WARP);
+
+    // --- 1️⃣ Smooth content, where both paths are expected to agree within the documented tolerance
+    cv::Mat frame(height, width, CV_8UC4);
+    for (int y = 0; y < height; ++y) {
+        uchar *p = frame.ptr<uchar>(y);
+        for (int x = 0; x < width; ++x)
+            for (int c = 0; c < 4; ++c)
+                p[4 * x + c] = cv::saturate_cast<uchar>(255.0 * (0.5 + 0.45 * std::sin(0.05 * x + 0.03 * y + c)));
+    }
+
+    // --- 2️⃣ Same warp as a gather table and as fixed-point remap maps
+    RowResampleTable table;
+    buildCylinderResampleTable(width, 4, radiusPx, interpolation, table, inverse);
+
+    cv::Mat mapX(height, width, CV_32FC1), mapY(height, width, CV_32FC1);
+    const float cx = width / 2.0f;
+    for (int x = 0; x < width; ++x) {
+        const float u = (x - cx) / radiusPx;
+        // Outside the arc the table writes black; a position left of the frame does the same for remap.
+        const float srcX = !inverse ? radiusPx * sinf(u) + cx
+                                    : std::fabs(u) <= 1.f ? radiusPx * asinf(u) + cx : -10.f;
+        for (int y = 0; y < height; ++y) {
+            mapX.at<float>(y, x) = srcX;
+            mapY.at<float>(y, x) = (float) y;
+        }
+    }
+    cv::Mat map1, map2;
+    cv::convertMaps(mapX, mapY, map1, map2, CV_16SC2);
+
+    // --- 3️⃣ Time both paths
+    cv::Mat rowOut, remapOut;
+    resampleRows(frame, rowOut, table);
+    int64_t t0 = monotonicNs();
+    for (int i = 0; i < iterations; ++i) resampleRows(frame, rowOut, table);
+    const double rowMs = (monotonicNs() - t0) / 1e6 / iterations;
+
+    cv::remap(frame, remapOut, map1, map2, interpolation, cv::BORDER_CONSTANT, cv::Scalar::all(0));
+    t0 = monotonicNs();
+    for (int i = 0; i < iterations; ++i)
+        cv::remap(frame, remapOut, map1, map2, interpolation, cv::BORDER_CONSTANT, cv::Scalar::all(0));
+    const double remapMs = (monotonicNs() - t0) / 1e6 / iterations;
+
+    const double maxDiff = cv::norm(rowOut, remapOut, cv::NORM_INF);
+    LOGI("Row resampler %dx%d: %.2f ms vs remap %.2f ms (x%.2f), max diff %.0f",
+         width, height, rowMs, remapMs, remapMs / rowMs, maxDiff);
+
+    const jfloat values[] = {(jfloat) rowMs, (jfloat) remapMs, (jfloat) (remapMs / rowMs), (jfloat) maxDiff};
+    jfloatArray result = env->NewFloatArray(4);
+    env->SetFloatArrayRegion(result, 0, 4, values);
+    return result;
+}
+
+/**
+ * Time to resolve every ChessBoardManager native by its exported JNI name, i.e. the
+ * lookups the runtime would do on first calls without RegisterNatives. This
+ * is a lower bound: the runtime also builds the mangled names and searches
+ * every loaded library.
+ */
+static int64_t symbolLookupNs() {
+    Dl_info info;
+    if (dladdr((void *) &symbolLookupNs, &info) == 0 || info.dli_fname == nullptr) return -1;
+    void *self = dlopen(info.dli_fname, RTLD_NOW | RTLD_NOLOAD);
+    if (self == nullptr) return -1;
+
+    jint count = 0;
+    const JNINativeMethod *methods = chessBoardManagerMethods(&count);
+    char name[256];
+    int missing = 0;
+    const int64_t t0 = monotonicNs();
+    for (jint i = 0; i < count; ++i) {
+        snprintf(name, sizeof(name), "Java_com_kuro_android_opencv_ChessBoardManager_%s", methods[i].name);
+        if (dlsym(self, name) == nullptr) ++missing;
+    }
+    const int64_t elapsed = monotonicNs() - t0;
+    dlclose(self);
+    if (missing > 0) LOGE("%d natives have no exported symbol", missing);
+    return elapsed;
+}
+
+/**
+ * Benchmark of the binding layer.
+ *
+ * Bitmap creation: the old per-call path (FindClass, GetStaticMethodID,
+ * GetStaticFieldID, then createBitmap) against newArgbBitmap with the
+ * references cached in JNI_OnLoad. Both create and drop a real 8x8 Bitmap, so
+ * the difference is what the generators save per call.
+ *
+ * Load time: the RegisterNatives call made in JNI_OnLoad against resolving
+ * the same natives through dlsym, the work lazy binding spreads over the
+ * first calls. Per-call dispatch once bound is measured from Kotlin, see
+ * NativeBenchmarks.benchmarkNativeDispatch.
+ *
+ * @param iterations Bitmaps created per variant.
+ * @return [uncachedNsPerBitmap, cachedNsPerBitmap, registerNativesUs, symbolLookupUs].
+ */
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkJniBinding(
+        JNIEnv *env,
+        jobject /*thiz*/,
+        jint iterations
+) {
+    TRACE_FUNCTION("benchmarkJniBinding");
+    const int n = iterations > 0 ? iterations : 1;
+    const int side = 8;
+
+    // --- 1️⃣ Old path: four lookups, createBitmap, local refs released
+    int64_t t0 = monotonicNs();
+    for (int i = 0; i < n; ++i) {
+        jclass bitmapCls = env->FindClass("android/graphics/Bitmap");
+        jmethodID mid = env->GetStaticMethodID(
+                bitmapCls, "createBitmap",
+                "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;");
+        jclass configCls = env->FindClass("android/graphics/Bitmap$Config");
+        jfieldID fid = env->GetStaticFieldID(configCls, "ARGB_8888", "Landroid/graphics/Bitmap$Config;");
+        jobject argb = env->GetStaticObjectField(configCls, fid);
+        jobject bitmap = env->CallStaticObjectMethod(bitmapCls, mid, side, side, argb);
+        env->DeleteLocalRef(bitmap);
+        env->DeleteLocalRef(argb);
+        env->DeleteLocalRef(configCls);
+        env->DeleteLocalRef(bitmapCls);
+    }
+    const double uncachedNs = (double) (monotonicNs() - t0) / n;
+
+    // --- 2️⃣ Cached path: what the generators do now
+    t0 = monotonicNs();
+    for (int i = 0; i < n; ++i) env->DeleteLocalRef(newArgbBitmap(env, side, side));
+    const double cachedNs = (double) (monotonicNs() - t0) / n;
+
+    // --- 3️⃣ Binding cost at load: RegisterNatives (measured in JNI_OnLoad) vs symbol lookup
+    const int64_t lookupNs = symbolLookupNs();
+
+    const jfloat values[] = {(jfloat) uncachedNs, (jfloat) cachedNs, (jfloat) (registerNativesNs() / 1000.0),
+                             (jfloat) (lookupNs / 1000.0)};
+    jfloatArray result = env->NewFloatArray(4);
+    env->SetFloatArrayRegion(result, 0, 4, values);
+    return result;
+}
+
+/** Empty native bound by RegisterNatives, timed from Kotlin. */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_NativeBenchmarks_nativeDispatchProbe(
+        JNIEnv * /*env*/,
+        jobject /*thiz*/
+) {
+}
+
+/**
+ * Same empty native, deliberately left out of the RegisterNatives table so
+ * the runtime binds it by symbol lookup on its first call.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_kuro_android_opencv_NativeBenchmarks_nativeDispatchProbeUnregistered(
+        JNIEnv * /*env*/,
+        jobject /*thiz*/
+) {
+}
@@ -0,0 +1,27 @@
+#ifndef NATIVE_BENCHMARKS_H
+#define NATIVE_BENCHMARKS_H
+
+#include <jni.h>
+
+/**
+ * Binds the natives of com.kuro.android.opencv.NativeBenchmarks. That class
+ * lives in the instrumentation APK only, so outside test runs it is not found:
+ * the lookup error is cleared and false is returned. Compiled into debug
+ * builds only (CHESSBOARD_NATIVE_BENCHMARKS).
+ */
+bool registerNativeBenchmarks(JNIEnv *env);
+
+/*
+ * NativeBenchmarks entry points. nativeDispatchProbeUnregistered is left out
+ * of the RegisterNatives table on purpose: it is bound by symbol lookup.
+ */
+extern "C" {
+JNIEXPORT jfloatArray JNICALL Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkRefineEngines(JNIEnv *, jobject, jint, jint, jint, jint, jfloat, jint, jlong);
+JNIEXPORT jfloatArray JNICALL Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkPredistortStream(JNIEnv *, jobject, jint, jint, jfloat, jint, jint);
+JNIEXPORT jfloatArray JNICALL Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkRowResampler(JNIEnv *, jobject, jint, jint, jfloat, jint, jboolean, jint);
+JNIEXPORT jfloatArray JNICALL Java_com_kuro_android_opencv_NativeBenchmarks_benchmarkJniBinding(JNIEnv *, jobject, jint);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_NativeBenchmarks_nativeDispatchProbe(JNIEnv *, jobject);
+JNIEXPORT void JNICALL Java_com_kuro_android_opencv_NativeBenchmarks_nativeDispatchProbeUnregistered(JNIEnv *, jobject);
+}
+
+#endif // NATIVE_BENCHMARKS_H
@@ -0,0 +1,67 @@
+#include "native_registry.h"
+
+HandleRegistry &HandleRegistry::instance() {
+    static HandleRegistry registry;
+    return registry;
+}
+
+int64_t HandleRegistry::add(std::shared_ptr<void> object, HandleType type, SizeFunc size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint32_t index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        index = (uint32_t) slots_.size();
+        slots_.emplace_back();
+    }
+
+    Slot &slot = slots_[index];
+    slot.object = std::move(object);
+    slot.size = size;
+    slot.type = type;
+    // Generation in the high half, index + 1 in the low half: handles are never 0.
+    return ((int64_t) slot.generation << 32) | (int64_t) (index + 1);
+}
+
+HandleRegistry::Slot *HandleRegistry::resolve(int64_t handle) {
+    const uint32_t index = (uint32_t) (handle & 0xffffffff) - 1;
+    const uint32_t generation = (uint32_t) ((uint64_t) handle >> 32);
+    if (index >= slots_.size()) return nullptr;
+
+    Slot &slot = slots_[index];
+    return slot.object && slot.generation == generation ? &slot : nullptr;
+}
+
+std::shared_ptr<void> HandleRegistry::lookup(int64_t handle, HandleType type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot *slot = resolve(handle);
+    return slot && slot->type == type ? slot->object : nullptr;
+}
+
+bool HandleRegistry::release(int64_t handle) {
+    std::shared_ptr<void> doomed; // destroyed after the lock is dropped
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot *slot = resolve(handle);
+        if (slot == nullptr) return false;
+
+        doomed.swap(slot->object);
+        // Skip 0 on wrap-around so a handle never collides with "no handle".
+        if (++slot->generation == 0) slot->generation = 1;
+        freeSlots_.push_back((uint32_t) (slot - slots_.data()));
+    }
+    return true;
+}
+
+void HandleRegistry::stats(HandleTypeStats *stats) {
+    for (int t = 0; t < HANDLE_TYPE_COUNT; ++t) stats[t] = {0, 0};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Slot &slot : slots_) {
+        if (!slot.object) continue;
+        stats[slot.type].count += 1;
+        stats[slot.type].bytes += (int64_t) slot.size(slot.object.get());
+    }
+}
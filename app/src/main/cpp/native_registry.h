@@ -0,0 +1,95 @@
+#ifndef NATIVE_REGISTRY_H
+#define NATIVE_REGISTRY_H
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/** Kinds of native objects handed to Kotlin; indexes the per-type statistics. */
+enum HandleType {
+    HANDLE_MAT = 0,
+    HANDLE_PREDISTORT_STREAM = 1,
+    HANDLE_MESH_WARP = 2,
+    HANDLE_CURVATURE_PROFILE = 3,
+    HANDLE_CALIBRATION_SESSION = 4,
+    HANDLE_TYPE_COUNT
+};
+
+/** Live objects and bytes of one HandleType. */
+struct HandleTypeStats {
+    int64_t count;
+    int64_t bytes;
+};
+
+/**
+ * Process-wide table of native objects owned through Kotlin-side handles.
+ *
+ * A handle packs a slot index with the slot's generation counter, so a handle
+ * that was already released (or whose slot was reused) is rejected instead of
+ * dereferencing freed memory, and releasing twice is a harmless no-op. That
+ * makes release safe to call from both close() and a Cleaner action.
+ *
+ * Objects are held by shared_ptr: lookup() keeps the object alive for the
+ * caller even if another thread releases the handle meanwhile. Each slot
+ * carries a size callback, so byte accounting follows objects whose
+ * footprint grows after creation. Thread-safe.
+ */
+class HandleRegistry {
+public:
+    typedef size_t (*SizeFunc)(const void *);
+
+    static HandleRegistry &instance();
+
+    /** Registers @p object and returns its handle (never 0). */
+    int64_t add(std::shared_ptr<void> object, HandleType type, SizeFunc size);
+
+    /** Returns the object behind @p handle, or null if stale or of another type. */
+    std::shared_ptr<void> lookup(int64_t handle, HandleType type);
+
+    /**
+     * Drops the registry's reference to @p handle.
+     * @return false if the handle was already released or never existed.
+     */
+    bool release(int64_t handle);
+
+    /** Per-type live counts and bytes; @p stats has HANDLE_TYPE_COUNT entries. */
+    void stats(HandleTypeStats *stats);
+
+private:
+    struct Slot {
+        std::shared_ptr<void> object;
+        SizeFunc size = nullptr;
+        HandleType type = HANDLE_MAT;
+        uint32_t generation = 1;
+    };
+
+    HandleRegistry() = default;
+    Slot *resolve(int64_t handle);
+
+    std::mutex mutex_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> freeSlots_;
+};
+
+inline size_t handleBytes(const cv::Mat &m) { return m.total() * m.elemSize(); }
+
+template <typename T>
+size_t handleBytes(const T &object) { return object.bytes(); }
+
+/** Takes ownership of @p object and registers it under @p type. */
+template <typename T>
+int64_t registerHandle(T *object, HandleType type) {
+    return HandleRegistry::instance().add(
+            std::shared_ptr<void>(object, [](void *p) { delete static_cast<T *>(p); }), type,
+            [](const void *p) { return handleBytes(*static_cast<const T *>(p)); });
+}
+
+/** Typed lookup; null if @p handle is stale or does not refer to a @p type object. */
+template <typename T>
+std::shared_ptr<T> lookupHandle(int64_t handle, HandleType type) {
+    return std::static_pointer_cast<T>(HandleRegistry::instance().lookup(handle, type));
+}
+
+#endif // NATIVE_REGISTRY_H
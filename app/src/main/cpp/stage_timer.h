@@ -0,0 +1,55 @@
+#ifndef STAGE_TIMER_H
+#define STAGE_TIMER_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Slots of the timing array filled by detectCurvatureFromMat, in
+ * nanoseconds. Mirrored by the TIMING_* constants in ChessBoardManager.kt.
+ */
+enum DetectTiming {
+    TIMING_CONVERT = 0, // color conversion to gray
+    TIMING_SEARCH = 1,  // findChessboardCorners
+    TIMING_REFINE = 2,  // sub-pixel refinement
+    TIMING_FIT = 3,     // row fits and mean radius
+    TIMING_DEBUG = 4,   // debug overlay and imwrite (0 unless debug is on)
+    TIMING_TOTAL = 5,   // whole call, including anything not attributed above
+    TIMING_COUNT
+};
+
+/** Monotonic clock in nanoseconds (steady_clock, i.e. CLOCK_MONOTONIC on Android). */
+inline int64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Charges elapsed time to DetectTiming slots: each lap() adds the time since
+ * the previous lap (or construction) to one slot. With a null array every
+ * call is a no-op and the clock is never read.
+ */
+class StageTimer {
+public:
+    explicit StageTimer(int64_t *timings)
+            : timings_(timings), start_(timings ? monotonicNs() : 0), last_(start_) {}
+
+    void lap(DetectTiming slot) {
+        if (!timings_) return;
+        const int64_t now = monotonicNs();
+        timings_[slot] += now - last_;
+        last_ = now;
+    }
+
+    /** Stores the time since construction in TIMING_TOTAL. */
+    void finish() {
+        if (timings_) timings_[TIMING_TOTAL] = monotonicNs() - start_;
+    }
+
+private:
+    int64_t *timings_;
+    int64_t start_;
+    int64_t last_;
+};
+
+#endif // STAGE_TIMER_H
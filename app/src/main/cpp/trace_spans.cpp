@@ -0,0 +1,149 @@
+#include "trace_spans.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    int64_t beginNs;
+    int64_t durationNs;
+    int32_t tid;
+};
+
+/** Ring slot; fields are relaxed atomics so a reader racing the writer is well defined. */
+struct TraceSlot {
+    std::atomic<const char *> name;
+    std::atomic<int64_t> beginNs;
+    std::atomic<int64_t> durationNs;
+    std::atomic<int32_t> tid;
+};
+
+/**
+ * One thread's span buffer. Single writer (the claiming thread), any number
+ * of readers. Rings are never freed; a ring released by an exiting thread is
+ * claimed by the next new thread, and its older events keep their own tid.
+ *
+ * Readers detect overwritten slots by re-reading head after the copy. The
+ * release fence in push() pairs with the acquire fence in the reader: a reader
+ * that sees any field of span h is guaranteed to then see head >= h, which
+ * marks the slot's previous occupant (h - kCapacity) as stale.
+ */
+struct TraceRing {
+    static const uint64_t kCapacity = 8192; // power of two, ~256 KiB per thread
+    TraceSlot slots[kCapacity];
+    std::atomic<uint64_t> head{0};
+    std::atomic<bool> inUse{true};
+    TraceRing *next = nullptr; // set once before the ring is published
+
+    void push(const TraceEvent &e) {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        TraceSlot &slot = slots[h & (kCapacity - 1)];
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(e.name, std::memory_order_relaxed);
+        slot.beginNs.store(e.beginNs, std::memory_order_relaxed);
+        slot.durationNs.store(e.durationNs, std::memory_order_relaxed);
+        slot.tid.store(e.tid, std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    TraceEvent load(uint64_t index) const {
+        const TraceSlot &slot = slots[index & (kCapacity - 1)];
+        return {slot.name.load(std::memory_order_relaxed), slot.beginNs.load(std::memory_order_relaxed),
+                slot.durationNs.load(std::memory_order_relaxed), slot.tid.load(std::memory_order_relaxed)};
+    }
+};
+
+std::atomic<TraceRing *> gRings{nullptr};
+std::atomic<int64_t> gOriginNs{0};
+
+/** Hands the thread's ring back for reuse when the thread exits. */
+struct ThreadRing {
+    TraceRing *ring = nullptr;
+    int32_t tid = 0;
+    ~ThreadRing() {
+        if (ring) ring->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRing tRing;
+
+TraceRing *claimRing() {
+    for (TraceRing *r = gRings.load(std::memory_order_acquire); r; r = r->next) {
+        bool expected = false;
+        if (r->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return r;
+    }
+    auto *ring = new TraceRing();
+    TraceRing *head = gRings.load(std::memory_order_relaxed);
+    do {
+        ring->next = head;
+    } while (!gRings.compare_exchange_weak(head, ring, std::memory_order_release,
+                                           std::memory_order_relaxed));
+    return ring;
+}
+
+} // namespace
+
+namespace trace_detail {
+
+std::atomic<bool> gEnabled{false};
+
+void record(const char *name, int64_t beginNs, int64_t endNs) {
+    if (!tRing.ring) {
+        tRing.ring = claimRing();
+        tRing.tid = (int32_t) gettid();
+    }
+    tRing.ring->push({name, beginNs, endNs - beginNs, tRing.tid});
+}
+
+} // namespace trace_detail
+
+void startTrace() {
+    gOriginNs.store(monotonicNs(), std::memory_order_relaxed);
+    trace_detail::gEnabled.store(true, std::memory_order_release);
+}
+
+void stopTrace() {
+    trace_detail::gEnabled.store(false, std::memory_order_release);
+}
+
+int writeChromeTrace(const char *path) {
+    const int64_t origin = gOriginNs.load(std::memory_order_relaxed);
+
+    // --- 1️⃣ Snapshot every ring, dropping slots the writer may have reused meanwhile
+    std::vector<TraceEvent> events;
+    for (TraceRing *r = gRings.load(std::memory_order_acquire); r; r = r->next) {
+        const uint64_t end = r->head.load(std::memory_order_acquire);
+        const uint64_t begin = end > TraceRing::kCapacity ? end - TraceRing::kCapacity : 0;
+        const size_t first = events.size();
+        for (uint64_t i = begin; i < end; ++i) events.push_back(r->load(i));
+
+        // Indexes below published + 1 - kCapacity share a slot with a span written
+        // (or being written) since the copy started. The fence keeps the slot loads
+        // above ordered before this head load (see TraceRing).
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t published = r->head.load(std::memory_order_relaxed);
+        const uint64_t firstValid = published + 1 > TraceRing::kCapacity ? published + 1 - TraceRing::kCapacity : 0;
+        const uint64_t stale = firstValid > begin ? std::min(firstValid - begin, end - begin) : 0;
+        events.erase(events.begin() + (long) first, events.begin() + (long) (first + stale));
+    }
+
+    // --- 2️⃣ Chrome trace JSON, timestamps in microseconds since startTrace()
+    FILE *f = fopen(path, "w");
+    if (f == nullptr) return -1;
+    const int pid = (int) getpid();
+    int written = 0;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+    for (const TraceEvent &e : events) {
+        if (e.beginNs < origin) continue;
+        fprintf(f, "%s\n{\"name\":\"%s\",\"cat\":\"native\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                written ? "," : "", e.name, (e.beginNs - origin) / 1000.0, e.durationNs / 1000.0, pid, e.tid);
+        ++written;
+    }
+    fputs("\n]}\n", f);
+    fclose(f);
+    return written;
+}
@@ -0,0 +1,101 @@
+#ifndef TRACE_SPANS_H
+#define TRACE_SPANS_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/utils/trace.hpp>
+#include <atomic>
+#include <cstdint>
+
+#include "stage_timer.h"
+
+/**
+ * Lightweight span tracing that can be written out as a Chrome trace
+ * (chrome://tracing, Perfetto UI).
+ *
+ * Each thread records completed spans into its own fixed-size ring buffer:
+ * the owning thread is the only writer and publishes with a release store of
+ * the head index, so recording never takes a lock or allocates once the
+ * thread's ring exists. When the ring is full the oldest spans are
+ * overwritten. While tracing is stopped a span costs one relaxed atomic load.
+ *
+ * The TRACE_* macros also open the matching OpenCV trace region
+ * (CV_TRACE_FUNCTION / CV_TRACE_REGION), so the same stages appear in
+ * OpenCV's own trace when it is enabled with OPENCV_TRACE=1.
+ */
+
+namespace trace_detail {
+extern std::atomic<bool> gEnabled;
+void record(const char *name, int64_t beginNs, int64_t endNs);
+} // namespace trace_detail
+
+inline bool traceEnabled() {
+    return trace_detail::gEnabled.load(std::memory_order_relaxed);
+}
+
+/** Starts recording; spans recorded before this call are no longer written out. */
+void startTrace();
+
+/** Stops recording; already recorded spans are kept until the next startTrace(). */
+void stopTrace();
+
+/**
+ * Writes every span recorded since startTrace() as Chrome trace JSON
+ * ("X" complete events, microsecond timestamps, one track per thread).
+ * Safe to call while tracing: spans overwritten during the copy are skipped.
+ *
+ * @return Number of spans written, -1 if @p path could not be opened.
+ */
+int writeChromeTrace(const char *path);
+
+/**
+ * Scoped span. @p name must be a string literal (or otherwise outlive the
+ * trace), since only the pointer is stored.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *name)
+            : name_(name), beginNs_(traceEnabled() ? monotonicNs() : 0) {}
+
+    ~TraceSpan() { close(); }
+
+    /** Ends the current span and starts @p name, for sequential stages in one scope. */
+    void next(const char *name) {
+        close();
+        name_ = name;
+        beginNs_ = traceEnabled() ? monotonicNs() : 0;
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    void close() {
+        if (beginNs_ != 0) trace_detail::record(name_, beginNs_, monotonicNs());
+        beginNs_ = 0;
+    }
+
+    const char *name_;
+    int64_t beginNs_;
+};
+
+/** Span over a whole function, e.g. a JNI entry point. */
+#define TRACE_FUNCTION(name) \
+    CV_TRACE_FUNCTION(); \
+    TraceSpan CVAUX_CONCAT(traceSpan_, __LINE__)(name)
+
+/** Span from here to the end of the enclosing block. */
+#define TRACE_SCOPE(name) \
+    CV_TRACE_REGION(name); \
+    TraceSpan CVAUX_CONCAT(traceSpan_, __LINE__)(name)
+
+/** First of a sequence of stages in one block; continue with TRACE_NEXT. */
+#define TRACE_STAGE(name) \
+    CV_TRACE_REGION(name); \
+    TraceSpan traceStage_(name)
+
+/** Closes the current TRACE_STAGE span and opens @p name. */
+#define TRACE_NEXT(name) \
+    CV_TRACE_REGION_NEXT(name); \
+    traceStage_.next(name)
+
+#endif // TRACE_SPANS_H
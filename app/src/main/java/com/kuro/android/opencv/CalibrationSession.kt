@@ -0,0 +1,76 @@
+package com.kuro.android.opencv
+
+import android.graphics.Bitmap
+import java.io.Closeable
+
+/**
+ * Stateful calibration for one chessboard grid ([cols] x [rows] inner corners).
+ *
+ * The native session keeps the gray frame, corner vector, fit arrays, warp
+ * table and rendered layout patterns between calls, so after the first frame
+ * detection and warping reuse the same buffers. Everything is freed on
+ * [close]. Use from a single thread.
+ */
+class CalibrationSession(val cols: Int, val rows: Int) : Closeable {
+
+    private val native = ChessBoardManager.createCalibrationSession(cols, rows)
+        .let { require(it != 0L) { "Invalid session grid" }; NativeHandle(it) }
+
+    /** Packed result of the last [detect], in the [CurvatureResult] layout. */
+    val result = FloatArray(CurvatureResult.sizeInFloats(cols, rows))
+
+    /** Detects the board in [matPtr] and fills [result]; returns the mean radius or -1. */
+    fun detect(
+        matPtr: Long,
+        refineMode: Int = ChessBoardManager.REFINE_SUBPIX,
+        fitMode: Int = ChessBoardManager.FIT_LEAST_SQUARES
+    ): Float {
+        check(!native.isClosed) { "CalibrationSession is closed" }
+        return ChessBoardManager.calibrationSessionDetect(native.handle, matPtr, result, 0, refineMode, fitMode)
+    }
+
+    /** Flattens [matPtr] in place, or pre-distorts it for the wall with [inverse]. */
+    fun warp(
+        matPtr: Long,
+        radiusPx: Float,
+        interpolation: Int = ChessBoardManager.WARP_LINEAR,
+        inverse: Boolean = false
+    ): Boolean {
+        check(!native.isClosed) { "CalibrationSession is closed" }
+        return ChessBoardManager.calibrationSessionWarp(native.handle, matPtr, radiusPx, interpolation, inverse)
+    }
+
+    /**
+     * Renders a layout pattern (see [ChessBoardManager.generateChessBoardGroupWithBlackPad])
+     * into [bitmap], reusing the cached canvas when the layout is unchanged.
+     */
+    fun renderPatternInto(
+        bitmap: Bitmap,
+        totalWidth: Int,
+        totalHeight: Int,
+        groupXOffset: Int,
+        groupYOffset: Int,
+        activeXOffset: Int,
+        activeYOffset: Int,
+        activeWidth: Int,
+        activeHeight: Int,
+        cols: Int,
+        rows: Int
+    ): Boolean {
+        check(!native.isClosed) { "CalibrationSession is closed" }
+        return ChessBoardManager.calibrationSessionPatternInto(
+            native.handle, bitmap, totalWidth, totalHeight, groupXOffset, groupYOffset,
+            bitmap.width, bitmap.height, activeXOffset, activeYOffset, activeWidth, activeHeight,
+            cols, rows
+        )
+    }
+
+    /**
+     * [frames, allocations, mapBuilds, patternBuilds, arenaBytes, bytes].
+     * allocations covers only the session's own buffers; use
+     * [ChessBoardManager.getMemoryStats] to see every Mat allocation per frame.
+     */
+    fun stats(): LongArray? = ChessBoardManager.calibrationSessionStats(native.handle)
+
+    override fun close() = native.close()
+}
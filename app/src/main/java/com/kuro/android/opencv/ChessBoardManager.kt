@@ -3,8 +3,62 @@ package com.kuro.android.opencv
 import android.content.Context
 import android.content.res.AssetManager
 import android.graphics.Bitmap
+import java.nio.ByteBuffer
+import java.nio.FloatBuffer
 
 object ChessBoardManager {
+    /** Sub-pixel refinement modes for [detectCurvatureFromMat]. */
+    const val REFINE_SUBPIX = 0
+    const val REFINE_SUBPIX_COARSE_TO_FINE = 1
+    const val REFINE_SADDLE = 2
+
+    /** Row/column fitting modes; robust modes reject mis-refined corners. */
+    const val FIT_LEAST_SQUARES = 0
+    const val FIT_RANSAC = 1
+    const val FIT_HUBER = 2
+    const val FIT_TUKEY = 3
+
+    /** Warp interpolation kernels (same values as OpenCV's INTER_LINEAR / INTER_CUBIC). */
+    const val WARP_LINEAR = 1
+    const val WARP_CUBIC = 2
+
+    /** Native handle types, indexing the pairs of [getNativeHandleStats]. */
+    const val HANDLE_MAT = 0
+    const val HANDLE_PREDISTORT_STREAM = 1
+    const val HANDLE_MESH_WARP = 2
+    const val HANDLE_CURVATURE_PROFILE = 3
+    const val HANDLE_CALIBRATION_SESSION = 4
+
+    /** Displacement interpolation for [MeshWarp]. */
+    const val MESH_BILINEAR = 0
+    const val MESH_THIN_PLATE = 1
+
+    /** Stage slots of the timings filled by [detectCurvatureFromMat] (monotonic nanoseconds). */
+    const val TIMING_CONVERT = 0
+    const val TIMING_SEARCH = 1
+    const val TIMING_REFINE = 2
+    const val TIMING_FIT = 3
+    const val TIMING_DEBUG = 4
+    const val TIMING_TOTAL = 5
+    const val TIMING_COUNT = 6
+
+    /** Stages of [getMemoryStats], matching MemoryStage in mat_allocator.h. */
+    const val MEM_STAGE_OTHER = 0
+    const val MEM_STAGE_CONVERT = 1
+    const val MEM_STAGE_DETECT = 2
+    const val MEM_STAGE_REFINE = 3
+    const val MEM_STAGE_FIT = 4
+    const val MEM_STAGE_WARP = 5
+    const val MEM_STAGE_PATTERN = 6
+    const val MEM_STAGE_COUNT = 7
+
+    /**
+     * Size of the array filled by [detectCylinderFromMat]: radius, radiusStd,
+     * rmsError, curvature, roll, pitch, yaw, perspective, scale, aspect, tx, ty,
+     * converged (1/0). Lengths are in image pixels, angles in radians.
+     */
+    const val CYLINDER_RESULT_SIZE = 13
+
     init {
         System.loadLibrary("opencv_java4")
         System.loadLibrary("generate_chessboard")
@@ -44,20 +98,368 @@ object ChessBoardManager {
         rows: Int
     ): Bitmap
 
+    /**
+     * Render-in-place variants of the generators: draw into [bitmap] (for
+     * example from [acquirePooledBitmap]) instead of creating a new one.
+     * The bitmap must be ARGB_8888 and exactly the requested size; otherwise
+     * false is returned and it is left untouched.
+     */
+    external fun generateChessBoardInto(
+        bitmap: Bitmap,
+        width: Int,
+        height: Int,
+        cols: Int,
+        rows: Int,
+        startX: Int,
+        startY: Int
+    ): Boolean
+
+    external fun generateChessBoardGroupInto(
+        bitmap: Bitmap,
+        totalWidth: Int,
+        totalHeight: Int,
+        groupXOffset: Int,
+        groupWidth: Int,
+        groupHeight: Int,
+        cols: Int,
+        rows: Int
+    ): Boolean
 
+    external fun generateChessBoardGroupWithBlackPadInto(
+        bitmap: Bitmap,
+        totalWidth: Int,
+        totalHeight: Int,
+        groupXOffset: Int,
+        groupYOffset: Int,
+        groupWidth: Int,
+        groupHeight: Int,
+        activeXOffset: Int,
+        activeYOffset: Int,
+        activeWidth: Int,
+        activeHeight: Int,
+        cols: Int,
+        rows: Int
+    ): Boolean
+
+    /**
+     * Native pool of reusable ARGB_8888 bitmaps keyed by size and format.
+     * [acquirePooledBitmap] reuses an idle bitmap when one matches; give it
+     * back with [recyclePooledBitmap] once it is no longer displayed. Returns
+     * null for a non-positive size or if the bitmap cannot be created. Stats:
+     * [hits, misses, recycled, dropped, pooled, bytes, capacityBytes].
+     */
+    external fun acquirePooledBitmap(width: Int, height: Int): Bitmap?
+    external fun recyclePooledBitmap(bitmap: Bitmap): Boolean
+    external fun getBitmapPoolStats(): LongArray
+    external fun setBitmapPoolCapacity(bytes: Long)
+    external fun clearBitmapPool()
+
+
+    /**
+     * Mean row radius in pixels, -1 if not found. If [timings] is given
+     * (at least [TIMING_COUNT] longs) it receives the nanoseconds spent in each
+     * stage, indexed by the TIMING_* constants.
+     */
     external fun detectCurvatureFromMat(
         matPtr: Long,
         cols: Int,
         rows: Int,
-        isDebug : Boolean = true
+        isDebug : Boolean = true,
+        refineMode: Int = REFINE_SUBPIX,
+        fitMode: Int = FIT_LEAST_SQUARES,
+        timings: LongArray? = null
     ): Float
 
+    /**
+     * Like [detectCurvatureFromMat], but also fills [out] from [offset] with the
+     * packed per-row and per-column fits (layout: [CurvatureResult]).
+     */
+    external fun detectCurvatureIntoArray(
+        matPtr: Long,
+        cols: Int,
+        rows: Int,
+        out: FloatArray,
+        offset: Int = 0,
+        isDebug: Boolean = false,
+        refineMode: Int = REFINE_SUBPIX,
+        fitMode: Int = FIT_LEAST_SQUARES
+    ): Float
+
+    /** Direct-buffer variant of [detectCurvatureIntoArray]; [buffer] must be direct. */
+    external fun detectCurvatureIntoBuffer(
+        matPtr: Long,
+        cols: Int,
+        rows: Int,
+        buffer: ByteBuffer,
+        isDebug: Boolean = false,
+        refineMode: Int = REFINE_SUBPIX,
+        fitMode: Int = FIT_LEAST_SQUARES
+    ): Float
+
+    /** Reuse-buffer overload for live mode: refills [result] in place. */
+    fun detectCurvatureInto(
+        matPtr: Long,
+        result: CurvatureResult,
+        refineMode: Int = REFINE_SUBPIX,
+        fitMode: Int = FIT_LEAST_SQUARES
+    ): Float = detectCurvatureIntoBuffer(
+        matPtr, result.cols, result.rows, result.buffer, false, refineMode, fitMode
+    )
+
+    /**
+     * Fits one cylinder to all corners and returns its radius in pixels (-1 on failure).
+     * Pass the same [out] array with [warmStart] = true across live frames to
+     * start each solve from the previous result.
+     */
+    external fun detectCylinderFromMat(
+        matPtr: Long,
+        cols: Int,
+        rows: Int,
+        out: FloatArray,
+        warmStart: Boolean = false,
+        refineMode: Int = REFINE_SUBPIX
+    ): Float
+
+    /**
+     * Fits a piecewise-radius wall. Breakpoints are restricted to [boundaries]
+     * (corner-column indices at cabinet edges) when given. [out] receives
+     * 4 floats per segment: startCol, endCol, signed radius in pixels (positive
+     * concave, negative convex) and RMS residual. Returns the segment count,
+     * or -1 if the chessboard was not found.
+     */
+    external fun detectSegmentedCurvature(
+        matPtr: Long,
+        cols: Int,
+        rows: Int,
+        boundaries: IntArray?,
+        out: FloatArray,
+        penalty: Float = 0f,
+        refineMode: Int = REFINE_SUBPIX
+    ): Int
+
+    /**
+     * Fits a quadric surface to all corners for dome/barrel walls. [out] (15 floats)
+     * receives the horizontal and vertical radii, the RMS residual (pixels) and
+     * the six x and six y surface coefficients.
+     */
+    external fun detectSurfaceCurvature(
+        matPtr: Long,
+        cols: Int,
+        rows: Int,
+        out: FloatArray,
+        refineMode: Int = REFINE_SUBPIX
+    ): Boolean
 
     external fun pixelRadiusToMeters(radiusPx: Float, pixelPitchMM: Float): Float
     external fun generateCurvatureProfile(width: Int, radiusPx: Float): FloatArray
-    external fun generateCurvatureMap(width: Int, height: Int, radiusPx: Float): Long
+
+    /**
+     * Allocation-free variants of [generateCurvatureProfile] for per-frame use:
+     * write [width] floats into [out] from [offset] (pinned, no copy), or into a
+     * direct buffer from its base address. Return false if the target is too
+     * small or not direct.
+     */
+    external fun generateCurvatureProfileIntoArray(
+        width: Int,
+        radiusPx: Float,
+        out: FloatArray,
+        offset: Int = 0
+    ): Boolean
+    external fun generateCurvatureProfileIntoByteBuffer(width: Int, radiusPx: Float, buffer: ByteBuffer): Boolean
+    external fun generateCurvatureProfileIntoFloatBuffer(width: Int, radiusPx: Float, buffer: FloatBuffer): Boolean
+
+    fun generateCurvatureProfileInto(width: Int, radiusPx: Float, buffer: ByteBuffer): Boolean =
+        generateCurvatureProfileIntoByteBuffer(width, radiusPx, buffer)
+
+    fun generateCurvatureProfileInto(width: Int, radiusPx: Float, buffer: FloatBuffer): Boolean =
+        generateCurvatureProfileIntoFloatBuffer(width, radiusPx, buffer)
+
+    /**
+     * Builds the normalized H x W curvature map and returns its registry handle
+     * (not a Mat address). Use [nativeMatAddr] to get the cv::Mat address and
+     * [releaseNative] (or a [NativeHandle]) to free it.
+     */
+    external fun generateCurvatureMapHandle(width: Int, height: Int, radiusPx: Float): Long
+
+    /** Native side of [CurvatureProfile]; prefer that wrapper. */
+    external fun createCurvatureProfile(width: Int, height: Int, radiusPx: Float): Long
+    /** Null if [handle] is not a live profile. */
+    external fun curvatureProfileRow(handle: Long): FloatArray?
+    external fun curvatureProfileDense(handle: Long): Long
+    external fun releaseCurvatureProfile(handle: Long)
+
     external fun warpCurvedToFlat(matPtr: Long, radiusPx: Float)
 
-    external fun warpCurvedToFlatInPlace(matPtr: Long, radiusPx: Float)
+    /**
+     * Flattens a cylindrical wall in place. 8U, 16U and 32F frames are processed
+     * row by row without a full-frame copy; [bandParallel] = false keeps the work
+     * on the calling thread with a single scratch row.
+     */
+    external fun warpCurvedToFlatInPlace(
+        matPtr: Long,
+        radiusPx: Float,
+        interpolation: Int = WARP_LINEAR,
+        bandParallel: Boolean = true
+    )
+
+    /**
+     * Inverse of [warpCurvedToFlatInPlace]: pre-distorts flat 8U/16U/32F content
+     * so it looks flat on a cylindrical wall of [radiusPx].
+     */
+    external fun warpFlatToCurvedInPlace(
+        matPtr: Long,
+        radiusPx: Float,
+        interpolation: Int = WARP_LINEAR,
+        bandParallel: Boolean = true
+    )
+
+    /**
+     * Undistorts (camera intrinsics from calibrateCamera) and flattens in a single
+     * cached remap. [cameraMatrix] is the row-major 3x3 matrix or [fx, fy, cx, cy];
+     * [distCoeffs] is k1, k2, p1, p2[, k3]. A radius <= 0 skips that flatten axis.
+     */
+    external fun warpUndistortFlatInPlace(
+        matPtr: Long,
+        radiusH: Float,
+        radiusV: Float,
+        cameraMatrix: FloatArray,
+        distCoeffs: FloatArray?,
+        interpolation: Int = WARP_LINEAR
+    )
+
+    /**
+     * Flattens only the viewport ([roiX], [roiY], [roiW], [roiH] in flattened
+     * full-resolution pixels) into [dstPtr] at [scale] display pixels per pixel,
+     * reading just the source region it needs (written to [srcRoiOut] as x, y, w, h).
+     * Pair with [ZoomableConcatView.visibleContentRect] for interactive zoom.
+     */
+    external fun warpFlatViewport(
+        srcPtr: Long,
+        dstPtr: Long,
+        radiusH: Float,
+        radiusV: Float,
+        roiX: Float,
+        roiY: Float,
+        roiW: Float,
+        roiH: Float,
+        scale: Float,
+        interpolation: Int = WARP_LINEAR,
+        srcRoiOut: IntArray? = null
+    ): Boolean
+
+    /** Native side of [PredistortStream]; prefer that wrapper. */
+    external fun createPredistortStream(
+        width: Int,
+        height: Int,
+        radiusPx: Float,
+        interpolation: Int = WARP_LINEAR
+    ): Long
+    /** Null if [handle] is not a live stream, [index] is not 0 or 1, or the buffer cannot be wrapped. */
+    external fun predistortStreamBuffer(handle: Long, index: Int): ByteBuffer?
+    external fun predistortFrame(handle: Long, frame: ByteBuffer): Int
+    external fun releasePredistortStream(handle: Long)
+
+    /** Native side of [MeshWarp]; prefer that wrapper. */
+    external fun createMeshWarp(
+        width: Int,
+        height: Int,
+        cols: Int,
+        rows: Int,
+        method: Int = MESH_BILINEAR,
+        meshStep: Int = 16
+    ): Long
+    external fun updateMeshWarp(handle: Long, matPtr: Long, refineMode: Int = REFINE_SUBPIX): Int
+    external fun applyMeshWarp(handle: Long, matPtr: Long, interpolation: Int = WARP_LINEAR): Boolean
+    external fun releaseMeshWarp(handle: Long)
+
+    /** Native side of [CalibrationSession]; prefer that wrapper. */
+    external fun createCalibrationSession(cols: Int, rows: Int): Long
+    external fun calibrationSessionDetect(
+        handle: Long,
+        matPtr: Long,
+        out: FloatArray?,
+        offset: Int = 0,
+        refineMode: Int = REFINE_SUBPIX,
+        fitMode: Int = FIT_LEAST_SQUARES
+    ): Float
+    external fun calibrationSessionWarp(
+        handle: Long,
+        matPtr: Long,
+        radiusPx: Float,
+        interpolation: Int = WARP_LINEAR,
+        inverse: Boolean = false,
+        bandParallel: Boolean = true
+    ): Boolean
+    external fun calibrationSessionPatternInto(
+        handle: Long,
+        bitmap: Bitmap,
+        totalWidth: Int,
+        totalHeight: Int,
+        groupXOffset: Int,
+        groupYOffset: Int,
+        groupWidth: Int,
+        groupHeight: Int,
+        activeXOffset: Int,
+        activeYOffset: Int,
+        activeWidth: Int,
+        activeHeight: Int,
+        cols: Int,
+        rows: Int
+    ): Boolean
+    external fun calibrationSessionStats(handle: Long): LongArray?
+    external fun releaseCalibrationSession(handle: Long)
+
+    /** Flattens a dome/barrel wall; a radius <= 0 leaves that axis untouched. */
+    external fun warpDomeToFlatInPlace(matPtr: Long, radiusH: Float, radiusV: Float)
+
+    /** cv::Mat address behind a Mat registry handle, 0 if the handle is stale. */
+    external fun nativeMatAddr(handle: Long): Long
+
+    /** Frees any registry handle; stale or repeated releases return false and do nothing. */
+    external fun releaseNative(handle: Long): Boolean
+
+    /**
+     * Native memory held through handles: [totalBytes, totalCount], then a
+     * (bytes, count) pair per HANDLE_* type.
+     */
+    external fun getNativeHandleStats(): LongArray
+
+    /** Total bytes currently held by objects behind native handles. */
+    external fun getNativeBytesHeld(): Long
+
+    /**
+     * Mat memory allocated by native pipeline calls: [pooledBytes,
+     * pooledBuffers, poolCapacityBytes], then for each MEM_STAGE_* five values
+     * [allocations, mallocs, currentBytes, peakBytes, totalBytes]. Mats made
+     * outside those calls, and temporaries on OpenCV's internal worker
+     * threads, are not pooled or counted.
+     */
+    external fun getMemoryStats(): LongArray
+
+    /** Resets the per-stage peaks of [getMemoryStats] to current usage. */
+    external fun resetMemoryPeaks()
+
+    /** Byte budget for idle pooled Mat buffers (default 16 MiB); raise it for 4K streams. */
+    external fun setMatPoolCapacity(bytes: Long)
+
+    /**
+     * Records native spans (every JNI entry point plus cvtColor, corner
+     * search, refinement, fits, map builds and remaps) into per-thread ring
+     * buffers until [stopNativeTrace]. Restarting discards earlier spans.
+     */
+    external fun startNativeTrace()
+    external fun stopNativeTrace()
+
+    /**
+     * Writes the recorded spans to [path] as Chrome trace JSON for
+     * chrome://tracing or ui.perfetto.dev. Returns the number of spans
+     * written, or -1 if the file could not be opened.
+     */
+    external fun writeNativeTrace(path: String): Int
+
+    /** Flatten map cache counters: [hits, misses, evictions, entries, bytes, capacityBytes]. */
+    external fun getWarpCacheStats(): LongArray
+    external fun setWarpCacheCapacity(bytes: Long)
+    external fun clearWarpCache()
 
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+package com.kuro.android.opencv
+
+import java.io.Closeable
+
+/**
+ * Normalized curvature height map of a cylindrical wall, held as one row.
+ *
+ * The map only varies along x, so [at] and [row] broadcast the W profile
+ * values to every row. [denseMatPtr] builds the full height x width CV_32F Mat
+ * natively the first time it is called (owned by this object, valid until
+ * [close]); avoid it unless a consumer really needs a dense Mat. Because that
+ * address outlives any reference to this object, the profile is never
+ * released by the garbage collector: always [close] it.
+ */
+class CurvatureProfile(val width: Int, val height: Int, radiusPx: Float) : Closeable {
+
+    private val native = ChessBoardManager.createCurvatureProfile(width, height, radiusPx)
+        .let { require(it != 0L) { "Invalid profile size" }; NativeHandle(it, autoRelease = false) }
+
+    /** The W normalized values shared by every row, copied on first access. */
+    val row: FloatArray by lazy {
+        check(!native.isClosed) { "CurvatureProfile is closed" }
+        checkNotNull(ChessBoardManager.curvatureProfileRow(native.handle)) { "CurvatureProfile handle is stale" }
+    }
+
+    fun at(x: Int, @Suppress("UNUSED_PARAMETER") y: Int): Float = row[x]
+
+    /** Address of the dense map, materialized on first call. */
+    fun denseMatPtr(): Long {
+        check(!native.isClosed) { "CurvatureProfile is closed" }
+        return ChessBoardManager.curvatureProfileDense(native.handle)
+    }
+
+    override fun close() = native.close()
+}
@@ -0,0 +1,66 @@
+package com.kuro.android.opencv
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
+
+/**
+ * Reusable holder for the structured output of
+ * [ChessBoardManager.detectCurvatureInto].
+ *
+ * The native side writes straight into [buffer] (a direct, native-order
+ * ByteBuffer), so one instance can be reused across frames in live mode.
+ * The float layout matches `packCurvatureResult` in curvature_fit.h:
+ * a 4-float header followed by one 6-float record per row, then per column.
+ */
+class CurvatureResult(val cols: Int, val rows: Int) {
+
+    val buffer: ByteBuffer = ByteBuffer
+        .allocateDirect(sizeInFloats(cols, rows) * Float.SIZE_BYTES)
+        .order(ByteOrder.nativeOrder())
+
+    private val floats: FloatBuffer = buffer.asFloatBuffer()
+
+    /** True if the chessboard was found in the last processed frame. */
+    val found: Boolean get() = floats.get(0) != 0f
+
+    /** Mean of the per-row radii in pixels, -1 if no row produced a fit. */
+    val meanRadius: Float get() = floats.get(1)
+
+    /** Radius in pixels of row [r], -1 if the row is flat or could not be fitted. */
+    fun rowRadius(r: Int): Float = floats.get(rowIndex(r))
+
+    /** Coefficients (a, b, c) of y = ax² + bx + c for row [r]. */
+    fun rowCoefficients(r: Int): FloatArray = coefficients(rowIndex(r))
+
+    /** RMS distance in pixels between the corners of row [r] and its fit. */
+    fun rowResidual(r: Int): Float = floats.get(rowIndex(r) + 4)
+
+    /** Corners of row [r] within the inlier threshold of its fit. */
+    fun rowInliers(r: Int): Int = floats.get(rowIndex(r) + 5).toInt()
+
+    /** Radius in pixels of column [c], -1 if the column is flat or could not be fitted. */
+    fun colRadius(c: Int): Float = floats.get(colIndex(c))
+
+    /** Coefficients (a, b, c) of x = ay² + by + c for column [c]. */
+    fun colCoefficients(c: Int): FloatArray = coefficients(colIndex(c))
+
+    /** RMS distance in pixels between the corners of column [c] and its fit. */
+    fun colResidual(c: Int): Float = floats.get(colIndex(c) + 4)
+
+    /** Corners of column [c] within the inlier threshold of its fit. */
+    fun colInliers(c: Int): Int = floats.get(colIndex(c) + 5).toInt()
+
+    private fun rowIndex(r: Int) = HEADER + STRIDE * r
+    private fun colIndex(c: Int) = HEADER + STRIDE * (rows + c)
+    private fun coefficients(index: Int) =
+        floatArrayOf(floats.get(index + 1), floats.get(index + 2), floats.get(index + 3))
+
+    companion object {
+        const val HEADER = 4
+        const val STRIDE = 6
+
+        /** Number of floats needed to hold a result for a [cols] x [rows] grid. */
+        fun sizeInFloats(cols: Int, rows: Int) = HEADER + STRIDE * (rows + cols)
+    }
+}
@@ -0,0 +1,42 @@
+package com.kuro.android.opencv
+
+import java.io.Closeable
+
+/**
+ * Flatten warp driven by the detected corner grid instead of an ideal arc,
+ * for walls that are not perfect cylinders centred in the frame.
+ *
+ * The native maps are cached: [update] rebuilds them only when the detected
+ * corners moved by more than a quarter pixel, and [apply] reuses them for
+ * every frame. Use from a single thread and [close] when done.
+ */
+class MeshWarp(
+    val width: Int,
+    val height: Int,
+    val cols: Int,
+    val rows: Int,
+    method: Int = ChessBoardManager.MESH_BILINEAR,
+    meshStep: Int = 16
+) : Closeable {
+
+    private val native = ChessBoardManager.createMeshWarp(width, height, cols, rows, method, meshStep)
+        .let { require(it != 0L) { "Invalid mesh warp parameters" }; NativeHandle(it) }
+
+    /**
+     * Detects the chessboard in [matPtr] and refreshes the maps if it moved.
+     * Returns 1 if rebuilt, 0 if the cached maps were kept, -1 if the Mat is
+     * empty or not the warp's size, or the board was not found.
+     */
+    fun update(matPtr: Long, refineMode: Int = ChessBoardManager.REFINE_SUBPIX): Int {
+        check(!native.isClosed) { "MeshWarp is closed" }
+        return ChessBoardManager.updateMeshWarp(native.handle, matPtr, refineMode)
+    }
+
+    /** Flattens [matPtr] in place; false until a successful [update] or on a size mismatch. */
+    fun apply(matPtr: Long, interpolation: Int = ChessBoardManager.WARP_LINEAR): Boolean {
+        check(!native.isClosed) { "MeshWarp is closed" }
+        return ChessBoardManager.applyMeshWarp(native.handle, matPtr, interpolation)
+    }
+
+    override fun close() = native.close()
+}
@@ -0,0 +1,52 @@
+package com.kuro.android.opencv
+
+import android.os.Build
+import androidx.annotation.RequiresApi
+import java.io.Closeable
+import java.lang.ref.Cleaner
+
+/**
+ * Owner of one native registry handle (see native_registry.h).
+ *
+ * [close] releases the native object. With [autoRelease] on API 33+ a
+ * [Cleaner] also releases it if the owner is garbage collected without being
+ * closed; the registry's generation counters make a release after [close] a
+ * no-op. The cleanup action captures only the handle, never this object.
+ *
+ * Owners that lend native memory to callers (direct ByteBuffers over native
+ * buffers, raw cv::Mat addresses) must pass autoRelease = false: nothing in
+ * what they hand out keeps the owner reachable, so a Cleaner could free that
+ * memory while it is still in use. Such owners must be closed explicitly.
+ */
+class NativeHandle(handle: Long, autoRelease: Boolean = true) : Closeable {
+
+    private val state = State(handle)
+
+    init {
+        require(handle != 0L) { "Invalid native handle" }
+        if (autoRelease && Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) Cleanup.register(this, state)
+    }
+
+    /** The registry handle, 0 once closed. */
+    val handle: Long get() = state.handle
+
+    val isClosed: Boolean get() = state.handle == 0L
+
+    override fun close() = state.run()
+
+    private class State(@Volatile var handle: Long) : Runnable {
+        override fun run() {
+            val h = synchronized(this) { handle.also { handle = 0L } }
+            if (h != 0L) ChessBoardManager.releaseNative(h)
+        }
+    }
+
+    @RequiresApi(Build.VERSION_CODES.TIRAMISU)
+    private object Cleanup {
+        private val cleaner: Cleaner = Cleaner.create()
+
+        fun register(owner: Any, action: Runnable) {
+            cleaner.register(owner, action)
+        }
+    }
+}
@@ -0,0 +1,47 @@
+package com.kuro.android.opencv
+
+import java.io.Closeable
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Real-time pre-distortion of RGBA video frames for playback on a cylindrical
+ * wall (flat -> curved, the inverse of [ChessBoardManager.warpCurvedToFlatInPlace]).
+ *
+ * Output is double-buffered in native memory: [process] writes the next frame
+ * into the back buffer and returns it, while the buffer returned by the
+ * previous call stays intact for upload or encoding. Nothing is allocated per
+ * frame. Use from a single thread and [close] when playback ends: the returned
+ * buffers point into native memory, so the stream is never released by the
+ * garbage collector and must not be closed while they are in use.
+ */
+class PredistortStream(
+    val width: Int,
+    val height: Int,
+    radiusPx: Float,
+    interpolation: Int = ChessBoardManager.WARP_LINEAR
+) : Closeable {
+
+    private val native = ChessBoardManager.createPredistortStream(width, height, radiusPx, interpolation)
+        .let { require(it != 0L) { "Invalid stream parameters" }; NativeHandle(it, autoRelease = false) }
+
+    private val outputs: Array<ByteBuffer> = Array(2) {
+        checkNotNull(ChessBoardManager.predistortStreamBuffer(native.handle, it)) {
+            "Cannot wrap output buffer $it"
+        }.order(ByteOrder.nativeOrder())
+    }
+
+    /**
+     * Pre-distorts [frame] (direct buffer, width * height * 4 bytes, RGBA) and
+     * returns the output buffer holding the result. It is overwritten by the
+     * call after next.
+     */
+    fun process(frame: ByteBuffer): ByteBuffer {
+        check(!native.isClosed) { "Stream is closed" }
+        val index = ChessBoardManager.predistortFrame(native.handle, frame)
+        require(index >= 0) { "Frame must be a direct buffer of ${width * height * 4} bytes" }
+        return outputs[index].duplicate().also { it.rewind() }
+    }
+
+    override fun close() = native.close()
+}
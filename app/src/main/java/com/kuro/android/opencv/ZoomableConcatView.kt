@@ -44,6 +44,21 @@ class ZoomableConcatView @JvmOverloads constructor(
         invalidate()
     }
 
+    /** Current zoom factor (view pixels per content pixel). */
+    val zoom: Float get() = scaleFactor
+
+    /**
+     * Region of the content (concatenated bitmaps, in bitmap pixels) that is
+     * currently visible, e.g. to render only that part at screen resolution.
+     */
+    fun visibleContentRect(): RectF {
+        val inverse = Matrix()
+        drawMatrix.invert(inverse)
+        val rect = RectF(0f, 0f, width.toFloat(), height.toFloat())
+        inverse.mapRect(rect)
+        return rect
+    }
+
     override fun onDraw(canvas: Canvas) {
         super.onDraw(canvas)
         canvas.save()
@@ -0,0 +1,387 @@
+#include "curvature_fit.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace cv;
+
+namespace {
+
+/**
+ * Row-major grid whose row r lies on y = a·(x - x0)² + b·(x - x0) + c + r·rowStep,
+ * with columns at x = x0 + xStep·(c - cols/2). The defaults keep every
+ * coordinate an exact float, so fits can be checked to rounding error.
+ */
+struct ParabolaGrid {
+    int cols = 9;
+    int rows = 6;
+    double x0 = 640.0;
+    double xStep = 64.0;
+    double a = 1.0 / 4096.0;
+    double b = 0.25;
+    double c = 100.0;
+    double rowStep = 32.0;
+
+    double y(int r, double x) const {
+        const double t = x - x0;
+        return a * t * t + b * t + c + r * rowStep;
+    }
+
+    std::vector<Point2f> corners() const {
+        std::vector<Point2f> pts;
+        for (int r = 0; r < rows; ++r) {
+            for (int k = 0; k < cols; ++k) {
+                const double x = x0 + xStep * (k - cols / 2);
+                pts.emplace_back((float) x, (float) y(r, x));
+            }
+        }
+        return pts;
+    }
+
+    // Coefficients of the same parabola in image x.
+    double imageA() const { return a; }
+    double imageB() const { return b - 2.0 * a * x0; }
+    double imageC(int r) const { return a * x0 * x0 - b * x0 + c + r * rowStep; }
+};
+
+} // namespace
+
+TEST(FitGridQuadratics, RecoversExactRowCoefficients) {
+    const ParabolaGrid grid;
+    const std::vector<Point2f> pts = grid.corners();
+    std::vector<QuadraticFit> rowFits(grid.rows), colFits(grid.cols);
+    fitGridQuadratics(pts.data(), grid.cols, grid.rows, rowFits.data(), colFits.data());
+
+    for (int r = 0; r < grid.rows; ++r) {
+        const QuadraticFit &f = rowFits[r];
+        ASSERT_TRUE(f.valid);
+        EXPECT_EQ(grid.cols, f.count);
+        EXPECT_EQ(grid.cols, f.inliers);
+        EXPECT_NEAR(grid.imageA(), f.a, 1e-12);
+        EXPECT_NEAR(grid.imageB(), f.b, 1e-9);
+        EXPECT_NEAR(grid.imageC(r), f.c, 1e-6);
+        EXPECT_NEAR(0.0, f.rmsResidual, 1e-6);
+        EXPECT_NEAR(2048.0, radiusFromQuadratic(f), 1e-6);
+    }
+}
+
+TEST(FitGridQuadratics, StraightColumnsAreFlat) {
+    const ParabolaGrid grid;
+    const std::vector<Point2f> pts = grid.corners();
+    std::vector<QuadraticFit> colFits(grid.cols);
+    fitGridQuadratics(pts.data(), grid.cols, grid.rows, nullptr, colFits.data());
+
+    for (int k = 0; k < grid.cols; ++k) {
+        const QuadraticFit &f = colFits[k];
+        ASSERT_TRUE(f.valid);
+        EXPECT_EQ(grid.rows, f.count);
+        EXPECT_NEAR(0.0, f.a, 1e-12);
+        EXPECT_NEAR(0.0, f.b, 1e-9);
+        EXPECT_NEAR(pts[k].x, f.c, 1e-6);
+        EXPECT_EQ(-1.0, radiusFromQuadratic(f));
+    }
+}
+
+TEST(FitGridQuadratics, StaysConditionedAtLargeCoordinates) {
+    // Far from the origin the raw power sums reach ~1e19; per-line centring
+    // must keep the solve exact.
+    ParabolaGrid grid;
+    grid.x0 = 32768.0;
+    grid.c = 16384.0;
+    const std::vector<Point2f> pts = grid.corners();
+    std::vector<QuadraticFit> rowFits(grid.rows);
+    fitGridQuadratics(pts.data(), grid.cols, grid.rows, rowFits.data(), nullptr);
+
+    for (int r = 0; r < grid.rows; ++r) {
+        const QuadraticFit &f = rowFits[r];
+        ASSERT_TRUE(f.valid);
+        EXPECT_NEAR(grid.imageA(), f.a, 1e-12);
+        EXPECT_NEAR(2048.0, radiusFromQuadratic(f), 1e-6);
+        EXPECT_NEAR(0.0, f.rmsResidual, 1e-6);
+        for (int k = 0; k < grid.cols; ++k) {
+            const Point2f &p = pts[r * grid.cols + k];
+            EXPECT_NEAR(p.y, (f.a * p.x + f.b) * p.x + f.c, 1e-6);
+        }
+    }
+}
+
+TEST(FitGridQuadratics, FewerThanThreePointsIsInvalid) {
+    ParabolaGrid grid;
+    grid.cols = 2;
+    grid.rows = 2;
+    const std::vector<Point2f> pts = grid.corners();
+    std::vector<QuadraticFit> rowFits(grid.rows), colFits(grid.cols);
+    fitGridQuadratics(pts.data(), grid.cols, grid.rows, rowFits.data(), colFits.data());
+
+    for (const QuadraticFit &f : rowFits) {
+        EXPECT_FALSE(f.valid);
+        EXPECT_EQ(2, f.count);
+        EXPECT_EQ(-1.0, radiusFromQuadratic(f));
+    }
+    for (const QuadraticFit &f : colFits) EXPECT_FALSE(f.valid);
+}
+
+namespace {
+
+const int OUTLIER_ROW = 2;
+const int OUTLIER_COL = 3;
+
+/** ParabolaGrid with one corner pushed 5 px off its row and column. */
+std::vector<Point2f> cornersWithOutlier(const ParabolaGrid &grid) {
+    std::vector<Point2f> pts = grid.corners();
+    pts[OUTLIER_ROW * grid.cols + OUTLIER_COL] += Point2f(5.f, 5.f);
+    return pts;
+}
+
+void fitRobust(const ParabolaGrid &grid, int mode, std::vector<QuadraticFit> &rowFits,
+               std::vector<QuadraticFit> &colFits) {
+    const std::vector<Point2f> pts = cornersWithOutlier(grid);
+    RobustFitParams params;
+    params.mode = mode;
+    rowFits.assign(grid.rows, QuadraticFit());
+    colFits.assign(grid.cols, QuadraticFit());
+    fitGridQuadraticsRobust(pts.data(), grid.cols, grid.rows, params, rowFits.data(), colFits.data());
+}
+
+} // namespace
+
+TEST(FitGridQuadraticsRobust, LeastSquaresIsPulledByTheOutlier) {
+    const ParabolaGrid grid;
+    std::vector<QuadraticFit> rowFits, colFits;
+    fitRobust(grid, FIT_LEAST_SQUARES, rowFits, colFits);
+
+    const QuadraticFit &f = rowFits[OUTLIER_ROW];
+    ASSERT_TRUE(f.valid);
+    EXPECT_GT(std::fabs(f.a - grid.imageA()), 0.05 * grid.imageA());
+    EXPECT_EQ(grid.cols, f.inliers);
+}
+
+TEST(FitGridQuadraticsRobust, RansacRejectsThePlantedOutlier) {
+    const ParabolaGrid grid;
+    std::vector<QuadraticFit> rowFits, colFits;
+    fitRobust(grid, FIT_RANSAC, rowFits, colFits);
+
+    for (int r = 0; r < grid.rows; ++r) {
+        const QuadraticFit &f = rowFits[r];
+        ASSERT_TRUE(f.valid);
+        EXPECT_EQ(grid.cols, f.count);
+        EXPECT_EQ(r == OUTLIER_ROW ? grid.cols - 1 : grid.cols, f.inliers);
+        EXPECT_NEAR(grid.imageA(), f.a, 1e-9);
+        EXPECT_NEAR(grid.imageC(r), f.c, 1e-3);
+        EXPECT_NEAR(0.0, f.rmsResidual, 1e-4);
+    }
+    const QuadraticFit &col = colFits[OUTLIER_COL];
+    ASSERT_TRUE(col.valid);
+    EXPECT_EQ(grid.rows - 1, col.inliers);
+    EXPECT_NEAR(0.0, col.a, 1e-9);
+}
+
+TEST(FitGridQuadraticsRobust, TukeyRejectsThePlantedOutlier) {
+    const ParabolaGrid grid;
+    std::vector<QuadraticFit> rowFits, colFits;
+    fitRobust(grid, FIT_TUKEY, rowFits, colFits);
+
+    for (int r = 0; r < grid.rows; ++r) {
+        const QuadraticFit &f = rowFits[r];
+        ASSERT_TRUE(f.valid);
+        EXPECT_EQ(r == OUTLIER_ROW ? grid.cols - 1 : grid.cols, f.inliers);
+        EXPECT_NEAR(grid.imageA(), f.a, 1e-9);
+        EXPECT_NEAR(0.0, f.rmsResidual, 1e-4);
+    }
+    EXPECT_EQ(grid.rows - 1, colFits[OUTLIER_COL].inliers);
+}
+
+TEST(FitGridQuadraticsRobust, HuberDownweightsThePlantedOutlier) {
+    const ParabolaGrid grid;
+    std::vector<QuadraticFit> lsRows, lsCols, rowFits, colFits;
+    fitRobust(grid, FIT_LEAST_SQUARES, lsRows, lsCols);
+    fitRobust(grid, FIT_HUBER, rowFits, colFits);
+
+    const QuadraticFit &f = rowFits[OUTLIER_ROW];
+    ASSERT_TRUE(f.valid);
+    EXPECT_LT(std::fabs(f.a - grid.imageA()), 0.1 * std::fabs(lsRows[OUTLIER_ROW].a - grid.imageA()));
+    EXPECT_EQ(grid.cols - 1, f.inliers);
+    EXPECT_EQ(grid.cols, rowFits[0].inliers);
+}
+
+TEST(FitGridQuadraticsRobust, ShortLinesFallBackToLeastSquares) {
+    ParabolaGrid grid;
+    grid.cols = 3;
+    const std::vector<Point2f> pts = grid.corners();
+    RobustFitParams params;
+    params.mode = FIT_RANSAC;
+    std::vector<QuadraticFit> rowFits(grid.rows);
+    fitGridQuadraticsRobust(pts.data(), grid.cols, grid.rows, params, rowFits.data(), nullptr);
+
+    for (const QuadraticFit &f : rowFits) {
+        ASSERT_TRUE(f.valid);
+        EXPECT_EQ(grid.cols, f.inliers);
+        EXPECT_NEAR(grid.imageA(), f.a, 1e-9);
+    }
+}
+
+namespace {
+
+/**
+ * Row-major grid whose columns [0, breakCol) lie on a wall of signed radius
+ * leftRadius and columns [breakCol, cols) on one of rightRadius, joined
+ * continuously. Rows above the centre bow up on a concave (positive) wall.
+ */
+struct SCurveGrid {
+    int cols = 16;
+    int rows = 6;
+    int breakCol = 8;
+    double leftRadius = 1000.0;
+    double rightRadius = -600.0;
+    double xStep = 40.0;
+    double rowStep = 50.0;
+
+    double x(int c) const { return 100.0 + xStep * c; }
+
+    double bow(int r, double radius, double t) const {
+        const double side = r < rows / 2 ? -1.0 : 1.0;
+        return side * t * t / (2.0 * radius);
+    }
+
+    std::vector<Point2f> corners() const {
+        const double leftMid = 0.5 * (x(0) + x(breakCol - 1));
+        const double rightMid = 0.5 * (x(breakCol) + x(cols - 1));
+        const double join = 0.5 * (x(breakCol - 1) + x(breakCol));
+        std::vector<Point2f> pts;
+        for (int r = 0; r < rows; ++r) {
+            const double base = 200.0 + r * rowStep;
+            const double offset = bow(r, leftRadius, join - leftMid) - bow(r, rightRadius, join - rightMid);
+            for (int c = 0; c < cols; ++c) {
+                const double y = c < breakCol ? bow(r, leftRadius, x(c) - leftMid)
+                                              : bow(r, rightRadius, x(c) - rightMid) + offset;
+                pts.emplace_back((float) x(c), (float) (base + y));
+            }
+        }
+        return pts;
+    }
+};
+
+} // namespace
+
+TEST(FitSegmentedCurvature, FindsTheBreakpointOfAnSCurve) {
+    const SCurveGrid grid;
+    const std::vector<Point2f> pts = grid.corners();
+    CurvatureSegment segments[4];
+    ASSERT_EQ(2, fitSegmentedCurvature(pts.data(), grid.cols, grid.rows, nullptr, 0, 0.0, segments, 4));
+
+    EXPECT_EQ(0, segments[0].startCol);
+    EXPECT_EQ(grid.breakCol, segments[0].endCol);
+    EXPECT_EQ(grid.breakCol, segments[1].startCol);
+    EXPECT_EQ(grid.cols, segments[1].endCol);
+
+    EXPECT_NEAR(grid.leftRadius, segments[0].radius, 0.5);
+    EXPECT_NEAR(grid.rightRadius, segments[1].radius, 0.5);
+    EXPECT_LT(segments[0].rmsResidual, 1e-3);
+    EXPECT_LT(segments[1].rmsResidual, 1e-3);
+}
+
+TEST(FitSegmentedCurvature, BreakpointsAreLimitedToTheGivenBoundaries) {
+    SCurveGrid grid;
+    grid.breakCol = 7;
+    const std::vector<Point2f> pts = grid.corners();
+    const int boundaries[] = {4, 8, 12};
+    CurvatureSegment segments[4];
+    const int count = fitSegmentedCurvature(pts.data(), grid.cols, grid.rows, boundaries, 3, 0.0,
+                                            segments, 4);
+    ASSERT_GE(count, 2);
+    for (int k = 1; k < count; ++k) {
+        const int cut = segments[k].startCol;
+        EXPECT_TRUE(cut == 4 || cut == 8 || cut == 12) << "cut at column " << cut;
+    }
+    EXPECT_GT(segments[0].radius, 0.0);
+    EXPECT_LT(segments[count - 1].radius, 0.0);
+}
+
+TEST(FitSegmentedCurvature, SingleRadiusWallIsOneSegment) {
+    SCurveGrid grid;
+    grid.rightRadius = grid.leftRadius;
+    grid.breakCol = grid.cols;
+    const std::vector<Point2f> pts = grid.corners();
+    CurvatureSegment segments[4];
+    ASSERT_EQ(1, fitSegmentedCurvature(pts.data(), grid.cols, grid.rows, nullptr, 0, 0.0, segments, 4));
+    EXPECT_EQ(0, segments[0].startCol);
+    EXPECT_EQ(grid.cols, segments[0].endCol);
+    EXPECT_NEAR(grid.leftRadius, segments[0].radius, 0.5);
+}
+
+TEST(FitSegmentedCurvature, TooFewColumnsGivesNoSegments) {
+    SCurveGrid grid;
+    grid.cols = 3;
+    grid.breakCol = 3;
+    const std::vector<Point2f> pts = grid.corners();
+    CurvatureSegment segments[4];
+    EXPECT_EQ(0, fitSegmentedCurvature(pts.data(), grid.cols, grid.rows, nullptr, 0, 0.0, segments, 4));
+}
+
+namespace {
+
+/** Corners of x = Σ X·φ(u,v), y = Σ Y·φ(u,v), sampled on the centred cols x rows grid. */
+std::vector<Point2f> quadricCorners(const double *X, const double *Y, int cols, int rows) {
+    std::vector<Point2f> pts;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const double u = c - 0.5 * (cols - 1), v = r - 0.5 * (rows - 1);
+            const double phi[6] = {1.0, u, v, u * u, u * v, v * v};
+            double x = 0.0, y = 0.0;
+            for (int i = 0; i < 6; ++i) {
+                x += X[i] * phi[i];
+                y += Y[i] * phi[i];
+            }
+            pts.emplace_back((float) x, (float) y);
+        }
+    }
+    return pts;
+}
+
+} // namespace
+
+TEST(FitQuadricSurface, RecoversKnownCoefficientsAndRadii) {
+    // Rows bend with curvature 2·0.5 / 64² and columns with 2·0.25 / 48²,
+    // i.e. radii of 4096 and 4608 px.
+    const double X[6] = {960.0, 64.0, 0.0, 0.0, 0.0, 0.25};
+    const double Y[6] = {540.0, 0.0, 48.0, 0.5, 0.0, 0.0};
+    const int cols = 9, rows = 7;
+    const std::vector<Point2f> pts = quadricCorners(X, Y, cols, rows);
+
+    SurfaceFit fit;
+    ASSERT_TRUE(fitQuadricSurface(pts.data(), cols, rows, fit));
+    EXPECT_TRUE(fit.valid);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_NEAR(X[i], fit.x[i], 1e-9) << "x[" << i << "]";
+        EXPECT_NEAR(Y[i], fit.y[i], 1e-9) << "y[" << i << "]";
+    }
+    EXPECT_NEAR(4096.0, fit.horizontalRadius, 1e-6);
+    EXPECT_NEAR(4608.0, fit.verticalRadius, 1e-6);
+    EXPECT_NEAR(0.0, fit.rmsResidual, 1e-9);
+}
+
+TEST(FitQuadricSurface, AffineGridIsFlatBothWays) {
+    const double X[6] = {640.0, 60.0, -8.0, 0.0, 0.0, 0.0};
+    const double Y[6] = {360.0, 4.0, 56.0, 0.0, 0.0, 0.0};
+    const int cols = 7, rows = 5;
+    const std::vector<Point2f> pts = quadricCorners(X, Y, cols, rows);
+
+    SurfaceFit fit;
+    ASSERT_TRUE(fitQuadricSurface(pts.data(), cols, rows, fit));
+    EXPECT_EQ(-1.0, fit.horizontalRadius);
+    EXPECT_EQ(-1.0, fit.verticalRadius);
+    EXPECT_NEAR(0.0, fit.rmsResidual, 1e-6);
+}
+
+TEST(FitQuadricSurface, FewerThanThreeRowsOrColumnsIsRejected) {
+    const double X[6] = {960.0, 64.0, 0.0, 0.0, 0.0, 0.25};
+    const double Y[6] = {540.0, 0.0, 48.0, 0.5, 0.0, 0.0};
+    SurfaceFit fit;
+    const std::vector<Point2f> wide = quadricCorners(X, Y, 9, 2);
+    EXPECT_FALSE(fitQuadricSurface(wide.data(), 9, 2, fit));
+    EXPECT_FALSE(fit.valid);
+    const std::vector<Point2f> tall = quadricCorners(X, Y, 2, 9);
+    EXPECT_FALSE(fitQuadricSurface(tall.data(), 2, 9, fit));
+    EXPECT_EQ(-1.0, fit.horizontalRadius);
+}
@@ -0,0 +1,143 @@
+#include "cylinder_fit.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace cv;
+
+namespace {
+
+/** Ground-truth pose of a cylindrical wall, in the parametrization of CylinderFit. */
+struct CylinderPose {
+    double curvature = 0.04; // per corner spacing
+    double yaw = 0.15;
+    double pitch = -0.08;
+    double perspective = 0.02;
+    double scale = 80.0;     // pixels per corner spacing, so R = 2000 px
+    double aspect = 1.0;
+    double roll = 0.03;
+    double tx = 960.0;
+    double ty = 540.0;
+
+    double radius() const { return scale / std::fabs(curvature); }
+};
+
+/** Projects every corner of a cols x rows grid, written out independently of the solver. */
+std::vector<Point2f> renderCylinder(const CylinderPose &p, int cols, int rows, double noise = 0.0,
+                                    unsigned seed = 1) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> gauss(0.0, noise > 0.0 ? noise : 1.0);
+    std::vector<Point2f> pts;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const double u = c - 0.5 * (cols - 1), v = r - 0.5 * (rows - 1);
+            const double k = p.curvature;
+            const double xw = std::sin(k * u) / k, zw = (1.0 - std::cos(k * u)) / k;
+            const double yw = p.aspect * v;
+
+            const double x1 = xw * std::cos(p.yaw) + zw * std::sin(p.yaw);
+            const double z1 = -xw * std::sin(p.yaw) + zw * std::cos(p.yaw);
+            const double y2 = yw * std::cos(p.pitch) - z1 * std::sin(p.pitch);
+            const double z2 = yw * std::sin(p.pitch) + z1 * std::cos(p.pitch);
+
+            const double w = 1.0 - p.perspective * z2;
+            const double px = p.scale * x1 / w, py = p.scale * y2 / w;
+            double x = p.tx + px * std::cos(p.roll) - py * std::sin(p.roll);
+            double y = p.ty + px * std::sin(p.roll) + py * std::cos(p.roll);
+            if (noise > 0.0) {
+                x += gauss(rng);
+                y += gauss(rng);
+            }
+            pts.emplace_back((float) x, (float) y);
+        }
+    }
+    return pts;
+}
+
+} // namespace
+
+TEST(FitCylinder, RecoversKnownRadiusAndPose) {
+    const CylinderPose truth;
+    const int cols = 11, rows = 7;
+    const std::vector<Point2f> pts = renderCylinder(truth, cols, rows);
+
+    CylinderFit fit;
+    ASSERT_TRUE(fitCylinder(pts.data(), cols, rows, fit, 100));
+    EXPECT_TRUE(fit.converged);
+    EXPECT_LT(fit.rmsError, 1e-3);
+    EXPECT_NEAR(truth.radius(), fit.radius, 1e-3 * truth.radius());
+    EXPECT_NEAR(truth.curvature, fit.curvature, 1e-5);
+    EXPECT_NEAR(truth.yaw, fit.yaw, 1e-3);
+    EXPECT_NEAR(truth.pitch, fit.pitch, 1e-3);
+    EXPECT_NEAR(truth.perspective, fit.perspective, 1e-4);
+    EXPECT_NEAR(truth.scale, fit.scale, 1e-2);
+    EXPECT_NEAR(truth.aspect, fit.aspect, 1e-4);
+    EXPECT_NEAR(truth.roll, fit.roll, 1e-4);
+    EXPECT_NEAR(truth.tx, fit.tx, 1e-2);
+    EXPECT_NEAR(truth.ty, fit.ty, 1e-2);
+}
+
+TEST(FitCylinder, ConvexWallHasNegativeCurvature) {
+    CylinderPose truth;
+    truth.curvature = -0.05;
+    const int cols = 11, rows = 7;
+    const std::vector<Point2f> pts = renderCylinder(truth, cols, rows);
+
+    CylinderFit fit;
+    ASSERT_TRUE(fitCylinder(pts.data(), cols, rows, fit, 100));
+    // The depth-mirrored solution projects identically; μ > 0 picks this one.
+    EXPECT_GT(fit.perspective, 0.0);
+    EXPECT_NEAR(truth.curvature, fit.curvature, 1e-5);
+    EXPECT_NEAR(truth.yaw, fit.yaw, 1e-3);
+    EXPECT_NEAR(truth.radius(), fit.radius, 1e-3 * truth.radius());
+}
+
+TEST(FitCylinder, BottomUpRowOrderGivesTheSameRadius) {
+    const CylinderPose truth;
+    const int cols = 11, rows = 7;
+    std::vector<Point2f> pts = renderCylinder(truth, cols, rows);
+    for (int r = 0; r < rows / 2; ++r)
+        std::swap_ranges(pts.begin() + r * cols, pts.begin() + (r + 1) * cols,
+                         pts.begin() + (rows - 1 - r) * cols);
+
+    CylinderFit fit;
+    ASSERT_TRUE(fitCylinder(pts.data(), cols, rows, fit, 100));
+    EXPECT_LT(fit.aspect, 0.0);
+    EXPECT_LT(fit.rmsError, 1e-3);
+    EXPECT_NEAR(truth.radius(), fit.radius, 1e-3 * truth.radius());
+}
+
+TEST(FitCylinder, NoisyCornersStayWithinTheReportedUncertainty) {
+    const CylinderPose truth;
+    const int cols = 11, rows = 7;
+    const std::vector<Point2f> pts = renderCylinder(truth, cols, rows, 0.1, 7);
+
+    CylinderFit fit;
+    ASSERT_TRUE(fitCylinder(pts.data(), cols, rows, fit, 100));
+    EXPECT_GT(fit.radiusStd, 0.0);
+    EXPECT_NEAR(0.1 * std::sqrt(2.0), fit.rmsError, 0.05);
+    EXPECT_NEAR(truth.radius(), fit.radius, 4.0 * fit.radiusStd);
+}
+
+TEST(FitCylinder, WarmStartConvergesImmediately) {
+    const CylinderPose truth;
+    const int cols = 11, rows = 7;
+    const std::vector<Point2f> pts = renderCylinder(truth, cols, rows);
+
+    CylinderFit fit;
+    ASSERT_TRUE(fitCylinder(pts.data(), cols, rows, fit, 100));
+    const int coldIterations = fit.iterations;
+    ASSERT_TRUE(fitCylinder(pts.data(), cols, rows, fit, 100, true));
+    EXPECT_LT(fit.iterations, coldIterations);
+    EXPECT_NEAR(truth.radius(), fit.radius, 1e-3 * truth.radius());
+}
+
+TEST(FitCylinder, RejectsGridsThatAreTooSmall) {
+    const std::vector<Point2f> pts = renderCylinder(CylinderPose(), 2, 2);
+    CylinderFit fit;
+    EXPECT_FALSE(fitCylinder(pts.data(), 2, 2, fit));
+    EXPECT_FALSE(fitCylinder(nullptr, 11, 7, fit));
+}